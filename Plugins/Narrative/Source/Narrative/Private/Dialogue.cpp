@@ -23,18 +23,31 @@
 #include "CineCameraComponent.h"
 #include "NarrativeDefaultCinecam.h"
 #include "Sound/SoundBase.h"
+#include "Animation/AnimMontage.h"
+#include "Engine/AssetManager.h"
+#include "Engine/StreamableManager.h"
 #include <Camera/CameraShakeBase.h>
 #include <EngineUtils.h>
 #include <Kismet/KismetMathLibrary.h>
 #include <DefaultLevelSequenceInstanceData.h>
 #include "NarrativeDialogueSequence.h"
 #include "NarrativePartyComponent.h"
+#include "NarrativeActorRegistry.h"
+#include "NarrativeDialoguePool.h"
+#include "NarrativeDialogueCache.h"
 
 
 static const FName NAME_PlayerSpeakerID("Player");
 static const FName NAME_FaceTag("Face");
 static const FName NAME_BodyTag("Body");
 static const FString NAME_PlayDialogueNodeTask("PlayDialogueNode");
+static const int32 MaxCursorReplyHistory = 64;
+
+static TAutoConsoleVariable<bool> CVarLogDialogueMediaResidency(
+	TEXT("narrative.LogDialogueMediaResidency"),
+	false,
+	TEXT("Log how much dialogue line media is prefetched and resident in memory whenever a dialogue updates its prefetch.\n")
+);
 
 UDialogue::UDialogue()
 {
@@ -45,6 +58,17 @@ UDialogue::UDialogue()
 	bFreeMovement = false;
 	bDeinitialized = false;
 	bBeganPlaying = false;
+	bChunkHasPendingConditions = false;
+	ChunkSeed = 0;
+	CurrentLineIndex = 0;
+	ChunkLinesPlayed = 0;
+	bPlayingPredictedChunk = false;
+	NodeTableChecksum = 0;
+	NodeSource = nullptr;
+	PredictedOptionChunkSeed = 0;
+	PendingChunkPlayerNode = nullptr;
+	PendingChunkStartTime = 0.f;
+	SpeculativeStateVersion = 0;
 	DefaultHeadBoneName = FName("head");
 	DialogueBlendOutTime = 0.f;
 
@@ -75,7 +99,18 @@ bool UDialogue::Initialize(class UNarrativeComponent* InitializingComp, FName St
 
 		if (UDialogueBlueprintGeneratedClass* BGClass = Cast<UDialogueBlueprintGeneratedClass>(GetClass()))
 		{
-			BGClass->InitializeDialogue(this);
+			//Reuse the nodes from an earlier dialogue of our class if the cache has some, otherwise duplicate them from our template
+			UWorld* World = InitializingComp->GetWorld();
+			UNarrativeDialogueCache* DialogueCache = World ? World->GetSubsystem<UNarrativeDialogueCache>() : nullptr;
+
+			if (UDialogue* CachedNodes = DialogueCache ? DialogueCache->AcquireNodes(BGClass, this) : nullptr)
+			{
+				TakeNodesFrom(CachedNodes);
+			}
+			else
+			{
+				BGClass->InitializeDialogue(this);
+			}
 
 			//If a dialogue doesn't have any npc replies, or doesn't have a valid root dialogue something has gone wrong 
 			if (NPCReplies.Num() == 0 || !RootDialogue)
@@ -125,12 +160,16 @@ bool UDialogue::Initialize(class UNarrativeComponent* InitializingComp, FName St
 				//Generate the first chunk of dialogue 
 				if (OwningComp->HasAuthority())
 				{
+					ChunkSeed = FMath::Rand();
+
 					const bool bHasValidDialogue = GenerateDialogueChunk(StartDialogue);
 
 					if (!bHasValidDialogue)
 					{
 						return false;
 					}
+
+					MarkChunkStart();
 				}
 
 				return true;
@@ -154,16 +193,22 @@ void UDialogue::Deinitialize()
 
 	StopDialogueSequence();
 
-	if (DialogueAudio)
+	if (GetWorld())
 	{
-		DialogueAudio->Stop();
-		DialogueAudio->DestroyComponent();
+		GetWorld()->GetTimerManager().ClearTimer(TimerHandle_PendingChunk);
 	}
 
-	if (DialogueSequencePlayer)
-	{
-		DialogueSequencePlayer->Destroy();
-	}
+	PendingChunkPlayerNode = nullptr;
+	DeferredPredictionCallbacks.Empty();
+
+	InvalidateSpeculativeChunks();
+	CleanupDialogueAudio();
+	ReleaseDialogueSequencePlayer();
+	ReleasePrefetchedMedia();
+
+	ConstantStringVariableCache.Empty();
+
+	ReleaseNodes();
 
 	OwningComp = nullptr; 
 	DefaultDialogueShot = nullptr;
@@ -204,10 +249,45 @@ void UDialogue::DuplicateAndInitializeFromDialogue(UDialogue* DialogueTemplate)
 		UDialogue* NewDialogue = Cast<UDialogue>(StaticDuplicateObject(DialogueTemplate, this, NAME_None, RF_Transactional));
 		NewDialogue->SetFlags(RF_Transient | RF_DuplicateTransient);
 
-		RootDialogue = NewDialogue->RootDialogue;
-		NPCReplies = NewDialogue->NPCReplies;
-		PlayerReplies = NewDialogue->PlayerReplies;
+		TakeNodesFrom(NewDialogue);
+	}
+}
+
+void UDialogue::TakeNodesFrom(UDialogue* InNodeSource)
+{
+	if (InNodeSource)
+	{
+		NodeSource = InNodeSource;
+
+		RootDialogue = NodeSource->RootDialogue;
+		NPCReplies = NodeSource->NPCReplies;
+		PlayerReplies = NodeSource->PlayerReplies;
+		NodeTableChecksum = NodeSource->NodeTableChecksum;
+
+		//Dialogues that haven't been recompiled since checksums were added won't have one baked
+		if (!NodeTableChecksum)
+		{
+			BakeNodeTableChecksum();
+		}
+	}
+}
+
+void UDialogue::ReleaseNodes()
+{
+	if (!NodeSource)
+	{
+		return;
+	}
+
+	if (UNarrativeDialogueCache* DialogueCache = GetWorld() ? GetWorld()->GetSubsystem<UNarrativeDialogueCache>() : nullptr)
+	{
+		DialogueCache->ReleaseNodes(GetClass(), NodeSource);
 	}
+
+	NodeSource = nullptr;
+	RootDialogue = nullptr;
+	NPCReplies.Empty();
+	PlayerReplies.Empty();
 }
 
 #if WITH_EDITOR
@@ -323,14 +403,14 @@ bool UDialogue::SkipCurrentLine()
 				{
 					if (PartyMember)
 					{
-						PartyMember->ClientRecieveDialogueChunk(MakeIDsFromNPCNodes(NPCReplyChain), MakeIDsFromPlayerNodes(AvailableResponses));
+						PartyMember->ClientRecieveDialogueChunk(PackCurrentChunk());
 					}
 				}
 			}
 			else
 			{
 				//RPC the dialogue chunk to the client so it can play it
-				OwningComp->ClientRecieveDialogueChunk(MakeIDsFromNPCNodes(NPCReplyChain), MakeIDsFromPlayerNodes(AvailableResponses));
+				OwningComp->ClientRecieveDialogueChunk(PackCurrentChunk());
 			}
 		}
 
@@ -401,11 +481,29 @@ bool UDialogue::SelectDialogueOption(UDialogueNode_Player* Option)
 	//Validate that the option that was selected is actually one of the available options
 	if (CanSelectDialogueOption(Option))// GenerateDialogueChunk() already did this && Option->AreConditionsMet(OwningPawn, OwningController, OwningComp))
 	{
+		//Only the most recent replies are kept, so looping dialogues can't grow the cursor forever
+		if (SelectedReplyIDs.Num() >= MaxCursorReplyHistory)
+		{
+			SelectedReplyIDs.RemoveAt(0);
+		}
+
+		SelectedReplyIDs.Add(Option->GetID());
+
 		PlayPlayerDialogueNode(Option);
 
 		if (OwningComp)
 		{
-			OwningComp->OnDialogueOptionSelected.Broadcast(this, Option);
+			if (IsPlayingPrediction())
+			{
+				DeferUntilConfirmed([this, Option]()
+				{
+					OwningComp->OnDialogueOptionSelected.Broadcast(this, Option);
+				});
+			}
+			else
+			{
+				OwningComp->OnDialogueOptionSelected.Broadcast(this, Option);
+			}
 		}
 
 		return true;
@@ -440,17 +538,19 @@ bool UDialogue::HasValidChunk() const
 
 bool UDialogue::GenerateDialogueChunk(UDialogueNode_NPC* NPCNode)
 {
+	bChunkHasPendingConditions = false;
+
 	if (NPCNode && OwningComp && OwningComp->HasAuthority())
 	{	
 		//Generate the NPC reply chain
-		NPCReplyChain = NPCNode->GetReplyChain(OwningController, OwningPawn, OwningComp);
+		NPCReplyChain = NPCNode->GetReplyChain(OwningController, OwningPawn, OwningComp, &bChunkHasPendingConditions);
 
 		//Grab all the players responses to the last thing the NPC had to say
 		if (NPCReplyChain.Num() && NPCReplyChain.IsValidIndex(NPCReplyChain.Num() - 1))
 		{
 			if (UDialogueNode_NPC* LastNPCNode = NPCReplyChain.Last())
 			{
-				AvailableResponses = LastNPCNode->GetPlayerReplies(OwningController, OwningPawn, OwningComp);
+				AvailableResponses = LastNPCNode->GetPlayerReplies(OwningController, OwningPawn, OwningComp, &bChunkHasPendingConditions);
 			}
 		}
 
@@ -464,38 +564,60 @@ bool UDialogue::GenerateDialogueChunk(UDialogueNode_NPC* NPCNode)
 	return false;
 }
 
-void UDialogue::ClientReceiveDialogueChunk(const TArray<FName>& NPCReplyIDs, const TArray<FName>& PlayerReplyIDs)
+void UDialogue::ClientReceiveDialogueChunk(const FPackedDialogueChunk& Chunk)
 {	
 	if (OwningComp && !OwningComp->HasAuthority())
 	{
-		
-		/**TODO definitely look at cleaning this up when we refactor 
-		We want to end the current line before playing the new chunk, but we can't call EndCurrentLine since it tries skipping to the next line, 
-		and even calls EndDialogue if we run out of lines, so here we're just doing most of what EndCurrentLine does manually, only without skipping to the next line. */
-		if (CurrentNode)
+		//Indices are meaningless if the server has a different version of the dialogue to us 
+		if (Chunk.NodeTableChecksum != NodeTableChecksum)
+		{
+			UE_LOG(LogNarrative, Error, TEXT("Dialogue %s received a chunk from a different version of the dialogue (server checksum %u, client checksum %u). Make sure client and server are running the same build."), *GetNameSafe(this), Chunk.NodeTableChecksum, NodeTableChecksum);
+
+			//We can't play a chunk we can't read, so rather than leave the player stuck in a conversation with nothing to say, leave it. Deinitializes us
+			OwningComp->AbortDesyncedDialogue();
+			return;
+		}
+
+		//If we predicted this chunk correctly it's already playing, so there's nothing to do 
+		if (bPlayingPredictedChunk)
 		{
-			if (DialogueAudio)
+			bPlayingPredictedChunk = false;
+
+			if (Chunk == PredictedChunk)
 			{
-				DialogueAudio->OnAudioFinished.RemoveAll(this);
+				RunConfirmedCallbacks(true);
+				return;
 			}
 
-			if (DialogueSequencePlayer && DialogueSequencePlayer->SequencePlayer)
+			UE_LOG(LogNarrative, Verbose, TEXT("Dialogue %s mispredicted a chunk, playing the servers chunk instead."), *GetNameSafe(this));
+
+			//None of the predicted chunks events or delegates should ever have happened
+			DeferredPredictionCallbacks.Empty();
+		}
+
+		InterruptCurrentNode();
+
+		//Resolve the nodes the server sent us, and play them
+		NPCReplyChain.Reset(Chunk.NPCReplyIndices.Num());
+		AvailableResponses.Reset(Chunk.PlayerReplyIndices.Num());
+
+		for (const int32 Index : Chunk.NPCReplyIndices)
+		{
+			if (NPCReplies.IsValidIndex(Index) && NPCReplies[Index])
 			{
-				DialogueSequencePlayer->SequencePlayer->OnFinished.RemoveAll(this);
+				NPCReplyChain.Add(NPCReplies[Index]);
 			}
+		}
 
-			if (GetWorld())
+		for (const int32 Index : Chunk.PlayerReplyIndices)
+		{
+			if (PlayerReplies.IsValidIndex(Index) && PlayerReplies[Index])
 			{
-				GetWorld()->GetTimerManager().ClearTimer(TimerHandle_NPCReplyFinished);
-				GetWorld()->GetTimerManager().ClearTimer(TimerHandle_PlayerReplyFinished);
+				AvailableResponses.Add(PlayerReplies[Index]);
 			}
-
-			FinishDialogueNode(CurrentNode, CurrentLine, CurrentSpeaker, CurrentSpeakerAvatar, CurrentListenerAvatar);
 		}
 
-		//Resolve the nodes the server sent us, and play them
-		NPCReplyChain = GetNPCRepliesByIDs(NPCReplyIDs);
-		AvailableResponses = GetPlayerRepliesByIDs(PlayerReplyIDs);
+		ChunkSeed = Chunk.ChunkSeed;
 
 		UE_LOG(LogTemp, Warning, TEXT("Client received a dialogue chunk: NPCReplyChain: %d, AvailableResponses: %d"), NPCReplyChain.Num(), AvailableResponses.Num());
 
@@ -503,6 +625,175 @@ void UDialogue::ClientReceiveDialogueChunk(const TArray<FName>& NPCReplyIDs, con
 	}
 }
 
+void UDialogue::InterruptCurrentNode()
+{
+	/**TODO definitely look at cleaning this up when we refactor 
+	We want to end the current line before playing the new chunk, but we can't call EndCurrentLine since it tries skipping to the next line, 
+	and even calls EndDialogue if we run out of lines, so here we're just doing most of what EndCurrentLine does manually, only without skipping to the next line. */
+	if (CurrentNode)
+	{
+		if (DialogueAudio)
+		{
+			DialogueAudio->OnAudioFinished.RemoveAll(this);
+		}
+
+		if (DialogueSequencePlayer && DialogueSequencePlayer->SequencePlayer)
+		{
+			DialogueSequencePlayer->SequencePlayer->OnFinished.RemoveAll(this);
+		}
+
+		if (GetWorld())
+		{
+			GetWorld()->GetTimerManager().ClearTimer(TimerHandle_NPCReplyFinished);
+			GetWorld()->GetTimerManager().ClearTimer(TimerHandle_PlayerReplyFinished);
+		}
+
+		FinishDialogueNode(CurrentNode, CurrentLine, CurrentSpeaker, CurrentSpeakerAvatar, CurrentListenerAvatar);
+	}
+}
+
+bool UDialogue::CanPredict() const
+{
+	const UNarrativeDialogueSettings* DialogueSettings = GetDefault<UNarrativeDialogueSettings>();
+
+	//Party dialogues can have options selected by other players, so only predict solo dialogues 
+	return DialogueSettings && DialogueSettings->bPredictDialogueOnClients && OwningComp && OwningComp->GetNetMode() == NM_Client && !OwningComp->IsA<UNarrativePartyComponent>();
+}
+
+bool UDialogue::PredictSelectDialogueOption(UDialogueNode_Player* Option)
+{
+	if (!CanPredict() || !Option)
+	{
+		return false;
+	}
+
+	const TArray<UDialogueNode_Player*> ResponsesBeforeSelecting = AvailableResponses;
+	PredictedOptionChunkSeed = ChunkSeed;
+
+	//Set before selecting, so the options events and delegates are held back until the server confirms it
+	PredictedOptionID = Option->GetID();
+
+	if (SelectDialogueOption(Option))
+	{
+		PredictedOptionResponses = ResponsesBeforeSelecting;
+		return true;
+	}
+
+	PredictedOptionID = NAME_None;
+	return false;
+}
+
+bool UDialogue::ReconcileSelectedOption(const FName& OptionID)
+{
+	if (PredictedOptionID.IsNone())
+	{
+		return false;
+	}
+
+	if (PredictedOptionID == OptionID)
+	{
+		PredictedOptionID = NAME_None;
+		PredictedOptionResponses.Empty();
+
+		RunConfirmedCallbacks(false);
+		return true;
+	}
+
+	UE_LOG(LogNarrative, Verbose, TEXT("Dialogue %s predicted option %s but the server selected %s, undoing prediction."), *GetNameSafe(this), *PredictedOptionID.ToString(), *OptionID.ToString());
+
+	//Stop whatever we predicted, and put the responses back so the servers option can be selected
+	InterruptCurrentNode();
+
+	//None of the predicted options events or delegates should ever have happened, nor any from a chunk we predicted after it
+	DeferredPredictionCallbacks.Empty();
+
+	NPCReplyChain.Empty();
+	AvailableResponses = PredictedOptionResponses;
+	ChunkSeed = PredictedOptionChunkSeed;
+	bPlayingPredictedChunk = false;
+
+	PredictedOptionID = NAME_None;
+	PredictedOptionResponses.Empty();
+
+	return false;
+}
+
+int32 UDialogue::MakeNextChunkSeed(const UDialogueNode_Player* PlayerNode) const
+{
+	return (int32)HashCombine(GetTypeHash(ChunkSeed), PlayerNode ? PlayerNode->GetStableIDHash() : 0);
+}
+
+UDialogueNode_NPC* UDialogue::FindNextNPCReply(UDialogueNode_Player* PlayerNode, bool& bOutPending)
+{
+	for (auto& NextNPCReply : PlayerNode->NPCReplies)
+	{
+		if (NextNPCReply)
+		{
+			const ENarrativeConditionResult Result = NextNPCReply->EvaluateConditions(OwningPawn, OwningController, OwningComp);
+
+			bOutPending |= Result == ENarrativeConditionResult::Pending;
+
+			if (UNarrativeNodeBase::ResolveConditionResult(Result))
+			{
+				return NextNPCReply;
+			}
+		}
+	}
+
+	return nullptr;
+}
+
+void UDialogue::PredictNextChunk(UDialogueNode_Player* PlayerNode)
+{
+	if (!PlayerNode || !CanPredict())
+	{
+		return;
+	}
+
+	bool bPending = false;
+
+	UDialogueNode_NPC* NextReply = FindNextNPCReply(PlayerNode, bPending);
+
+	if (!NextReply || bPending)
+	{
+		return;
+	}
+
+	TArray<UDialogueNode_NPC*> PredictedReplyChain = NextReply->GetReplyChain(OwningController, OwningPawn, OwningComp, &bPending);
+	TArray<UDialogueNode_Player*> PredictedResponses;
+
+	if (PredictedReplyChain.Num())
+	{
+		if (UDialogueNode_NPC* LastNPCNode = PredictedReplyChain.Last())
+		{
+			PredictedResponses = LastNPCNode->GetPlayerReplies(OwningController, OwningPawn, OwningComp, &bPending);
+		}
+	}
+
+	//If we can't be confident in the chunk just wait for the servers one 
+	if (bPending)
+	{
+		return;
+	}
+
+	NPCReplyChain = PredictedReplyChain;
+	AvailableResponses = PredictedResponses;
+
+	if (!HasValidChunk())
+	{
+		NPCReplyChain.Empty();
+		AvailableResponses.Empty();
+		return;
+	}
+
+	ChunkSeed = MakeNextChunkSeed(PlayerNode);
+
+	bPlayingPredictedChunk = true;
+	PredictedChunk = PackCurrentChunk();
+
+	Play();
+}
+
 void UDialogue::Play()
 {
 	if (!bBeganPlaying)
@@ -511,6 +802,9 @@ void UDialogue::Play()
 		bBeganPlaying = true;
 	}
 
+	//We've got a new chunk, so start streaming in whatever media it can reach
+	UpdateMediaPrefetch();
+
 	//Start playing through the NPCs replies until we run out
 	if (NPCReplyChain.Num())
 	{
@@ -581,6 +875,7 @@ void UDialogue::InitSpeakerAvatars()
 		{
 			//Track spawned avatars
 			SpeakerAvatars.Add(Speaker.SpeakerID, SpeakerActor);
+			CacheSpeakerAvatarMeshes(SpeakerActor);
 			Speaker.SpeakerAvatarTransform = SpeakerActor->GetActorTransform(); 
 		}
 	}
@@ -623,6 +918,7 @@ void UDialogue::InitSpeakerAvatars()
 						MemberSpeakerInfo.SpeakerID = Name_PID;
 
 						SpeakerAvatars.Add(MemberSpeakerInfo.SpeakerID, SpeakerActor);
+						CacheSpeakerAvatarMeshes(SpeakerActor);
 
 						//Hide the party members pawn; we've spawned them an avatar 
 						if (APawn* PawnOwner = PartyMember->GetPawn())
@@ -650,6 +946,7 @@ void UDialogue::InitSpeakerAvatars()
 		if (AActor* SpeakerActor = LinkSpeakerAvatar(PlayerSpeakerInfo))
 		{
 			SpeakerAvatars.Add(PlayerSpeakerInfo.SpeakerID, SpeakerActor);
+			CacheSpeakerAvatarMeshes(SpeakerActor);
 			PlayerSpeakerInfo.SpeakerAvatarTransform = SpeakerActor->GetActorTransform();
 
 			//By default if the player has a speaker avatar in the world we'll hide their pawn
@@ -692,6 +989,75 @@ void UDialogue::CleanUpSpeakerAvatars()
 	}
 
 	SpeakerAvatars.Empty();
+	SpeakerAvatarMeshes.Empty();
+}
+
+FSpeakerAvatarMeshes& UDialogue::CacheSpeakerAvatarMeshes(AActor* Avatar)
+{
+	FSpeakerAvatarMeshes& Meshes = SpeakerAvatarMeshes.FindOrAdd(Avatar);
+
+	Meshes.BodyMeshes.Reset();
+	Meshes.FaceMeshes.Reset();
+
+	if (Avatar)
+	{
+		TInlineComponentArray<USkeletalMeshComponent*> SkelMeshes(Avatar);
+
+		for (USkeletalMeshComponent* SkelMesh : SkelMeshes)
+		{
+			FSpeakerMeshCache MeshCache;
+			MeshCache.Mesh = SkelMesh;
+			MeshCache.AnimInstance = SkelMesh->GetAnimInstance();
+
+			if (SkelMesh->ComponentHasTag(NAME_BodyTag))
+			{
+				Meshes.BodyMeshes.Add(MeshCache);
+			}
+
+			if (SkelMesh->ComponentHasTag(NAME_FaceTag))
+			{
+				Meshes.FaceMeshes.Add(MeshCache);
+			}
+		}
+	}
+
+	return Meshes;
+}
+
+FSpeakerAvatarMeshes& UDialogue::GetSpeakerAvatarMeshes(AActor* Avatar)
+{
+	if (FSpeakerAvatarMeshes* Meshes = SpeakerAvatarMeshes.Find(Avatar))
+	{
+		//If the avatar has had its meshes swapped out since we cached them, refresh the cache
+		bool bStale = false;
+
+		for (const FSpeakerMeshCache& MeshCache : Meshes->BodyMeshes)
+		{
+			bStale |= !MeshCache.Mesh.IsValid();
+		}
+
+		for (const FSpeakerMeshCache& MeshCache : Meshes->FaceMeshes)
+		{
+			bStale |= !MeshCache.Mesh.IsValid();
+		}
+
+		if (!bStale)
+		{
+			return *Meshes;
+		}
+	}
+
+	return CacheSpeakerAvatarMeshes(Avatar);
+}
+
+UAnimInstance* FSpeakerMeshCache::GetAnimInstance()
+{
+	if (!AnimInstance.IsValid() && Mesh.IsValid())
+	{
+		AnimInstance = Mesh->GetAnimInstance();
+	}
+
+	return AnimInstance.Get();
 }
 
 void UDialogue::BlendingOutFinished()
@@ -752,58 +1118,154 @@ void UDialogue::ProcessNodeEvents(class UDialogueNode* Node, bool bStartEvents)
 }
 
 
-bool UDialogue::IsPartyDialogue() const
+void UDialogue::ProcessOrDeferNodeEvents(class UDialogueNode* Node, bool bStartEvents)
 {
-	return OwningComp && OwningComp->IsPartyComponent();
+	if (IsPlayingPrediction())
+	{
+		DeferUntilConfirmed([this, Node, bStartEvents]()
+		{
+			ProcessNodeEvents(Node, bStartEvents);
+		});
+	}
+	else
+	{
+		ProcessNodeEvents(Node, bStartEvents);
+	}
 }
 
-void UDialogue::SetPartyCurrentSpeaker(class APlayerState* Speaker)
+bool UDialogue::IsPlayingPrediction() const
 {
-	CurrentPartySpeakerAvatar = Speaker;
+	return bPlayingPredictedChunk || !PredictedOptionID.IsNone();
 }
 
-FVector UDialogue::GetConversationCenterPoint() const
+void UDialogue::DeferUntilConfirmed(TFunction<void()>&& Callback)
 {
-	TArray<AActor*> SpeakerActors;
+	FDeferredPredictionCallback& Deferred = DeferredPredictionCallbacks.AddDefaulted_GetRef();
+	Deferred.bFromPredictedChunk = bPlayingPredictedChunk;
+	Deferred.Callback = MoveTemp(Callback);
+}
 
-	//Figure out where the middle of the conversation is 
-	for (auto& Speaker : SpeakerAvatars)
+void UDialogue::RunConfirmedCallbacks(const bool bChunkConfirmed)
+{
+	/*The server always confirms our option before it sends the chunk that follows it, and option callbacks are always queued ahead of 
+	chunk callbacks, so confirming just the option runs everything up to the first callback from the predicted chunk.*/
+	int32 NumConfirmed = DeferredPredictionCallbacks.Num();
+
+	if (!bChunkConfirmed)
 	{
-		if (Speaker.Value)
-		{
-			SpeakerActors.Add(Speaker.Value);
-		}
+		NumConfirmed = DeferredPredictionCallbacks.IndexOfByPredicate([](const FDeferredPredictionCallback& Deferred) { return Deferred.bFromPredictedChunk; });
+		NumConfirmed = NumConfirmed == INDEX_NONE ? DeferredPredictionCallbacks.Num() : NumConfirmed;
 	}
 
-	FVector LocationSum(0, 0, 0); // sum of locations
-	int32 ActorCount = 0; // num actors
-	// iterate over actors
-	for (int32 ActorIdx = 0; ActorIdx < SpeakerActors.Num(); ActorIdx++)
+	//Take the callbacks out first, since running them may defer more
+	TArray<FDeferredPredictionCallback> Confirmed;
+	Confirmed.Append(DeferredPredictionCallbacks.GetData(), NumConfirmed);
+	DeferredPredictionCallbacks.RemoveAt(0, NumConfirmed);
+
+	for (FDeferredPredictionCallback& Deferred : Confirmed)
 	{
-		AActor* A = SpeakerActors[ActorIdx];
-		// Check actor is non-null, not deleted, and has a root component
-		if (IsValid(A) && A->GetRootComponent())
+		//An earlier event may have ended the dialogue
+		if (!OwningComp)
 		{
-			LocationSum += A->GetActorLocation();
-			ActorCount++;
+			return;
 		}
+
+		Deferred.Callback();
 	}
+}
 
-	// Find average
-	FVector Average(0, 0, 0);
-	if (ActorCount > 0)
+void UDialogue::BroadcastNPCLineStarted(class UDialogueNode_NPC* Node, const FDialogueLine& Line, const FSpeakerInfo& Speaker)
+{
+	if (OwningComp)
 	{
-		Average = LocationSum / ((float)ActorCount);
+		OwningComp->OnNPCDialogueLineStarted.Broadcast(this, Node, Line, Speaker);
 	}
 
-	return Average;
+	OnNPCDialogueLineStarted(Node, Line, Speaker);
 }
 
-void UDialogue::OnEndDialogue()
+void UDialogue::BroadcastNPCLineFinished(class UDialogueNode_NPC* Node, const FDialogueLine& Line, const FSpeakerInfo& Speaker)
 {
-	K2_OnEndDialogue();
-
-	SetPartyCurrentSpeaker(nullptr);
+	if (OwningComp)
+	{
+		OwningComp->OnNPCDialogueLineFinished.Broadcast(this, Node, Line, Speaker);
+	}
+
+	OnNPCDialogueLineFinished(Node, Line, Speaker);
+}
+
+void UDialogue::BroadcastPlayerLineStarted(class UDialogueNode_Player* Node, const FDialogueLine& Line)
+{
+	if (OwningComp)
+	{
+		OwningComp->OnPlayerDialogueLineStarted.Broadcast(this, Node, Line);
+	}
+
+	OnPlayerDialogueLineStarted(Node, Line);
+}
+
+void UDialogue::BroadcastPlayerLineFinished(class UDialogueNode_Player* Node, const FDialogueLine& Line)
+{
+	if (OwningComp)
+	{
+		OwningComp->OnPlayerDialogueLineFinished.Broadcast(this, Node, Line);
+	}
+
+	OnPlayerDialogueLineFinished(Node, Line);
+}
+
+bool UDialogue::IsPartyDialogue() const
+{
+	return OwningComp && OwningComp->IsPartyComponent();
+}
+
+void UDialogue::SetPartyCurrentSpeaker(class APlayerState* Speaker)
+{
+	CurrentPartySpeakerAvatar = Speaker;
+}
+
+FVector UDialogue::GetConversationCenterPoint() const
+{
+	TArray<AActor*> SpeakerActors;
+
+	//Figure out where the middle of the conversation is 
+	for (auto& Speaker : SpeakerAvatars)
+	{
+		if (Speaker.Value)
+		{
+			SpeakerActors.Add(Speaker.Value);
+		}
+	}
+
+	FVector LocationSum(0, 0, 0); // sum of locations
+	int32 ActorCount = 0; // num actors
+	// iterate over actors
+	for (int32 ActorIdx = 0; ActorIdx < SpeakerActors.Num(); ActorIdx++)
+	{
+		AActor* A = SpeakerActors[ActorIdx];
+		// Check actor is non-null, not deleted, and has a root component
+		if (IsValid(A) && A->GetRootComponent())
+		{
+			LocationSum += A->GetActorLocation();
+			ActorCount++;
+		}
+	}
+
+	// Find average
+	FVector Average(0, 0, 0);
+	if (ActorCount > 0)
+	{
+		Average = LocationSum / ((float)ActorCount);
+	}
+
+	return Average;
+}
+
+void UDialogue::OnEndDialogue()
+{
+	K2_OnEndDialogue();
+
+	SetPartyCurrentSpeaker(nullptr);
 
 	if (OwningController && DialogueBlendOutTime > 0.f)
 	{
@@ -817,11 +1279,9 @@ void UDialogue::OnEndDialogue()
 		}
 	}
 
-	if (DialogueSequencePlayer && DialogueSequencePlayer->SequencePlayer)
-	{
-		DialogueSequencePlayer->SequencePlayer->Stop();
-		DialogueSequencePlayer->Destroy();
-	}
+	ReleaseDialogueSequencePlayer();
+	CleanupDialogueAudio();
+
 	if (OwningPawn)
 	{
 		OwningPawn->SetActorHiddenInGame(false);
@@ -921,13 +1381,22 @@ void UDialogue::NPCFinishedTalking()
 		}
 
 		//NPC has finished talking. Let UI know it can show the player replies. Party comps don't need to broadcast this, clients put their own ones up
-		OwningComp->OnDialogueRepliesAvailable.Broadcast(this, AvailableResponses);
+		if (IsPlayingPrediction())
+		{
+			DeferUntilConfirmed([this, Responses = AvailableResponses]()
+			{
+				OwningComp->OnDialogueRepliesAvailable.Broadcast(this, Responses);
+			});
+		}
+		else
+		{
+			OwningComp->OnDialogueRepliesAvailable.Broadcast(this, AvailableResponses);
+		}
 
-		//Also make sure we stop playing any dialogue audio that was previously playing
+		//Also make sure we stop playing any dialogue audio that was previously playing. The component is kept around for the speakers next line
 		if (DialogueAudio)
 		{
 			DialogueAudio->Stop();
-			DialogueAudio->DestroyComponent();
 		}
 	}
 	else
@@ -947,12 +1416,15 @@ void UDialogue::PlayNPCDialogueNode(class UDialogueNode_NPC* NPCReply)
 	if (NPCReply)
 	{
 		CurrentNode = NPCReply;
-		CurrentLine = NPCReply->GetRandomLine(OwningComp->GetNetMode() == NM_Standalone);
+		UpdateMediaPrefetch();
+
+		CurrentLine = NPCReply->GetSeededLine(OwningComp->GetNetMode() == NM_Standalone, ChunkSeed);
+		++CurrentLineIndex;
 		ReplaceStringVariables(NPCReply, CurrentLine, CurrentLine.Text);
 
 		CurrentSpeaker = GetSpeaker(NPCReply->SpeakerID);
 
-		ProcessNodeEvents(NPCReply, true);
+		ProcessOrDeferNodeEvents(NPCReply, true);
 
 		//ProcessNodeEvents can result in a call to deinit, nulling out owning comp. Check if this occured
 		if (!OwningComp)
@@ -970,13 +1442,18 @@ void UDialogue::PlayNPCDialogueNode(class UDialogueNode_NPC* NPCReply)
 		//Actual playing of the node is inside a BlueprintNativeEvent so designers can override how NPC dialogues are played 
 		PlayNPCDialogue(NPCReply, CurrentLine, CurrentSpeaker);
 
-		if (OwningComp)
+		//Call delegates and BPNativeEvents
+		if (IsPlayingPrediction())
 		{
-			//Call delegates and BPNativeEvents
-			OwningComp->OnNPCDialogueLineStarted.Broadcast(this, NPCReply, CurrentLine, CurrentSpeaker);
+			DeferUntilConfirmed([this, NPCReply, Line = CurrentLine, Speaker = CurrentSpeaker]()
+			{
+				BroadcastNPCLineStarted(NPCReply, Line, Speaker);
+			});
+		}
+		else
+		{
+			BroadcastNPCLineStarted(NPCReply, CurrentLine, CurrentSpeaker);
 		}
-
-		OnNPCDialogueLineStarted(NPCReply, CurrentLine, CurrentSpeaker);
 
 		const float Duration = GetLineDuration(CurrentNode, CurrentLine);
 
@@ -1013,8 +1490,9 @@ void UDialogue::PlayPlayerDialogueNode(class UDialogueNode_Player* PlayerReply)
 		AvailableResponses.Empty();
 
 		CurrentNode = PlayerReply;
+		UpdateMediaPrefetch();
 		
-		ProcessNodeEvents(PlayerReply, true);
+		ProcessOrDeferNodeEvents(PlayerReply, true);
 
 		//ProcessNodeEvents can result in a call to deinit, nulling out owning comp. Check if this occured
 		if (!OwningComp)
@@ -1029,13 +1507,22 @@ void UDialogue::PlayPlayerDialogueNode(class UDialogueNode_Player* PlayerReply)
 			return;
 		}
 
-		CurrentLine = PlayerReply->GetRandomLine(OwningComp->GetNetMode() == NM_Standalone);
+		CurrentLine = PlayerReply->GetSeededLine(OwningComp->GetNetMode() == NM_Standalone, ChunkSeed);
+		++CurrentLineIndex;
 		ReplaceStringVariables(PlayerReply, CurrentLine, CurrentLine.Text);
 
 		//Call delegates and BPNativeEvents
-		OwningComp->OnPlayerDialogueLineStarted.Broadcast(this, PlayerReply, CurrentLine);
-
-		OnPlayerDialogueLineStarted(PlayerReply, CurrentLine);
+		if (IsPlayingPrediction())
+		{
+			DeferUntilConfirmed([this, PlayerReply, Line = CurrentLine]()
+			{
+				BroadcastPlayerLineStarted(PlayerReply, Line);
+			});
+		}
+		else
+		{
+			BroadcastPlayerLineStarted(PlayerReply, CurrentLine);
+		}
 
 		//Actual playing of the node is inside a BlueprintNativeEvent so designers can override how NPC dialogues are played 
 		PlayPlayerDialogue(PlayerReply, CurrentLine);
@@ -1062,35 +1549,93 @@ void UDialogue::PlayPlayerDialogueNode(class UDialogueNode_Player* PlayerReply)
 
 void UDialogue::ReplaceStringVariables(const class UDialogueNode* Node, const FDialogueLine& Line, FText& OutLine)
 {
-	//Replace variables in dialogue line
-	FString LineString = OutLine.ToString();
+	const FString& LineString = OutLine.ToString();
+
+	//Nodes cache the segments their text splits into, whatever culture it's in, so this is only searched the first time the text is shown
+	TSharedPtr<const TArray<FDialogueTextSegment>> SegmentsRef;
+
+	if (Node)
+	{
+		SegmentsRef = Node->GetTextSegments(LineString);
+	}
+	else
+	{
+		TSharedRef<TArray<FDialogueTextSegment>> LocalSegments = MakeShared<TArray<FDialogueTextSegment>>();
+		FDialogueLine::TokenizeString(LineString, *LocalSegments);
+		SegmentsRef = LocalSegments;
+	}
 
-	int32 OpenBraceIdx = -1;
-	int32 CloseBraceIdx = -1;
-	bool bFoundOpenBrace = LineString.FindChar('{', OpenBraceIdx);
-	bool bFoundCloseBrace = LineString.FindChar('}', CloseBraceIdx);
-	uint32 Iters = 0; // More than 50 wildcard replaces and something has probably gone wrong, so safeguard against that
+	const TArray<FDialogueTextSegment>* Segments = SegmentsRef.Get();
 
-	while (bFoundOpenBrace && bFoundCloseBrace && OpenBraceIdx < CloseBraceIdx && Iters < 50)
+	if (!Segments->ContainsByPredicate([](const FDialogueTextSegment& Segment) { return Segment.bIsVariable; }))
 	{
-		const FString VariableName = LineString.Mid(OpenBraceIdx + 1, CloseBraceIdx - OpenBraceIdx - 1);
-		const FString VariableVal = GetStringVariable(Node, Line, VariableName);
+		return;
+	}
+
+	TMap<FString, FString> VariableValues;
+	ResolveStringVariables(Node, Line, *Segments, VariableValues);
 
-		if (!VariableVal.IsEmpty())
+	//Work out how big the final line will be so we only need to allocate once 
+	int32 FinalLength = 0;
+
+	for (const FDialogueTextSegment& Segment : *Segments)
+	{
+		const FString* VariableVal = Segment.bIsVariable ? VariableValues.Find(Segment.Text) : nullptr;
+		FinalLength += VariableVal && !VariableVal->IsEmpty() ? VariableVal->Len() : Segment.Text.Len() + 2;
+	}
+
+	FString FinalLine;
+	FinalLine.Reserve(FinalLength);
+
+	for (const FDialogueTextSegment& Segment : *Segments)
+	{
+		if (!Segment.bIsVariable)
 		{
-			LineString.RemoveAt(OpenBraceIdx, CloseBraceIdx - OpenBraceIdx + 1);
-			LineString.InsertAt(OpenBraceIdx, VariableVal);
+			FinalLine += Segment.Text;
+			continue;
 		}
 
-		bFoundOpenBrace = LineString.FindChar('{', OpenBraceIdx);
-		bFoundCloseBrace = LineString.FindChar('}', CloseBraceIdx);
+		//Variables without a value are left in the line as they were 
+		const FString* VariableVal = VariableValues.Find(Segment.Text);
 
-		Iters++;
+		if (VariableVal && !VariableVal->IsEmpty())
+		{
+			FinalLine += *VariableVal;
+		}
+		else
+		{
+			FinalLine.AppendChar('{');
+			FinalLine += Segment.Text;
+			FinalLine.AppendChar('}');
+		}
 	}
 
-	if (Iters > 0)
+	OutLine = FText::FromString(MoveTemp(FinalLine));
+}
+
+void UDialogue::ResolveStringVariables(const class UDialogueNode* Node, const FDialogueLine& Line, const TArray<FDialogueTextSegment>& Segments, TMap<FString, FString>& OutValues)
+{
+	for (const FDialogueTextSegment& Segment : Segments)
 	{
-		OutLine = FText::FromString(LineString);
+		if (!Segment.bIsVariable || OutValues.Contains(Segment.Text))
+		{
+			continue;
+		}
+
+		if (const FString* CachedVal = ConstantStringVariableCache.Find(Segment.Text))
+		{
+			OutValues.Add(Segment.Text, *CachedVal);
+			continue;
+		}
+
+		const FString VariableVal = GetStringVariable(Node, Line, Segment.Text);
+
+		if (ConstantStringVariables.Contains(Segment.Text))
+		{
+			ConstantStringVariableCache.Add(Segment.Text, VariableVal);
+		}
+
+		OutValues.Add(Segment.Text, VariableVal);
 	}
 }
 
@@ -1190,19 +1735,33 @@ void UDialogue::FinishNPCDialogue()
 		{
 			if (OwningComp->HasAuthority())
 			{
+				++ChunkLinesPlayed;
 				OwningComp->CompleteNarrativeDataTask(NAME_PlayDialogueNodeTask, NPCNode->GetID().ToString());
 			}
 
-			ProcessNodeEvents(NPCNode, false);
+			ProcessOrDeferNodeEvents(NPCNode, false);
 
 			//We need to re-check OwningComp validity, as ProcessEvents may have ended this dialogue
 			if (OwningComp)
 			{
 				//Call delegates and BPNativeEvents
-				OwningComp->OnNPCDialogueLineFinished.Broadcast(this, NPCNode, CurrentLine, CurrentSpeaker);
-				OnNPCDialogueLineFinished(NPCNode, CurrentLine, CurrentSpeaker);
+				if (IsPlayingPrediction())
+				{
+					DeferUntilConfirmed([this, NPCNode, Line = CurrentLine, Speaker = CurrentSpeaker]()
+					{
+						BroadcastNPCLineFinished(NPCNode, Line, Speaker);
+					});
+				}
+				else
+				{
+					BroadcastNPCLineFinished(NPCNode, CurrentLine, CurrentSpeaker);
+				}
 
-				PlayNextNPCReply();
+				//Broadcasting may have ended this dialogue
+				if (OwningComp)
+				{
+					PlayNextNPCReply();
+				}
 			}
 		}
 	}
@@ -1224,18 +1783,45 @@ void UDialogue::FinishPlayerDialogue()
 		FinishDialogueNode(PlayerNode, CurrentLine, CurrentSpeaker, CurrentSpeakerAvatar, CurrentListenerAvatar);
 
 		//Call delegates and BPNativeEvents
-		OwningComp->OnPlayerDialogueLineFinished.Broadcast(this, PlayerNode, CurrentLine);
-		OnPlayerDialogueLineFinished(PlayerNode, CurrentLine);
+		if (IsPlayingPrediction())
+		{
+			DeferUntilConfirmed([this, PlayerNode, Line = CurrentLine]()
+			{
+				BroadcastPlayerLineFinished(PlayerNode, Line);
+			});
+		}
+		else
+		{
+			BroadcastPlayerLineFinished(PlayerNode, CurrentLine);
+		}
 
 		//No need, generate dialogue chunk already did this: if (PlayerNode->AreConditionsMet(OwningPawn, OwningController, OwningComp))
 		{
 			//Both auth and local need to run the events
-			ProcessNodeEvents(PlayerNode, false);
+			ProcessOrDeferNodeEvents(PlayerNode, false);
 
 			if (OwningComp && OwningComp->HasAuthority())
 			{
+				//Speculative chunks already accounted for this task being completed, so completing it shouldn't invalidate them
+				const uint32 VersionBeforeTask = OwningComp->GetNarrativeStateVersion();
+				const bool bSpeculationUpToDate = VersionBeforeTask == SpeculativeStateVersion;
+
 				OwningComp->CompleteNarrativeDataTask(NAME_PlayDialogueNodeTask, PlayerNode->GetID().ToString());
 
+				if (OwningComp)
+				{
+					/*Speculation only ever saw the task count go up, which is exactly one version bump. If anything else changed, ie a quest listening 
+					for the task moved on, the speculative chunks were never checked against that so they have to go*/
+					if (bSpeculationUpToDate && OwningComp->GetNarrativeStateVersion() == VersionBeforeTask + 1)
+					{
+						SpeculativeStateVersion = OwningComp->GetNarrativeStateVersion();
+					}
+					else
+					{
+						InvalidateSpeculativeChunks();
+					}
+				}
+
 				//Player selected a reply with nothing leading off it, dialogue has ended 
 				if (PlayerNode->NPCReplies.Num() <= 0)
 				{
@@ -1243,48 +1829,214 @@ void UDialogue::FinishPlayerDialogue()
 					return;
 				}
 
-				//Find the first valid NPC reply after the option we selected
-				UDialogueNode_NPC* NextReply = nullptr;
-
-				for (auto& NextNPCReply : PlayerNode->NPCReplies)
+				//Conditions on the upcoming nodes get a fresh look each time we generate a chunk
+				for (auto& Node : GetNodes())
 				{
-					if (NextNPCReply && NextNPCReply->AreConditionsMet(OwningPawn, OwningController, OwningComp))
+					if (Node)
 					{
-						NextReply = NextNPCReply;
-						break;
+						Node->ResetLatentConditions();
 					}
 				}
 
-				//If we can generate more dialogue from the reply that was selected, do so, otherwise exit dialogue 
-				if (GenerateDialogueChunk(NextReply))
+				PendingChunkStartTime = GetWorld() ? GetWorld()->GetTimeSeconds() : 0.f;
+				GenerateNextChunk(PlayerNode);
+			}
+			else if (CanPredict() && PlayerNode->NPCReplies.Num())
+			{
+				//Rather than wait a round trip for the servers next chunk, play the chunk we expect it to send. It'll be corrected if we got it wrong 
+				for (auto& Node : GetNodes())
 				{
-					//If we're Party, inform all party members a new chunk has arrived to play
-					if (UNarrativePartyComponent* PartyComp = Cast<UNarrativePartyComponent>(OwningComp))//OwningComp->IsPartyComponent())
-					{
-						for (auto& PartyMember : PartyComp->GetPartyMembers())
-						{
-							if (PartyMember)
-							{
-								PartyMember->ClientRecieveDialogueChunk(MakeIDsFromNPCNodes(NPCReplyChain), MakeIDsFromPlayerNodes(AvailableResponses));
-							}
-						}
-					}
-					else
+					if (Node)
 					{
-						//RPC the dialogue chunk to the client so it can play it
-						OwningComp->ClientRecieveDialogueChunk(MakeIDsFromNPCNodes(NPCReplyChain), MakeIDsFromPlayerNodes(AvailableResponses));
+						Node->ResetLatentConditions();
 					}
-
-					Play();
 				}
-				else
+
+				PredictNextChunk(PlayerNode);
+			}
+		}
+
+	}
+}
+
+void UDialogue::GenerateNextChunk(UDialogueNode_Player* PlayerNode)
+{
+	const bool bRetryingPendingChunk = PendingChunkPlayerNode && PendingChunkPlayerNode == PlayerNode;
+	PendingChunkPlayerNode = nullptr;
+
+	if (!PlayerNode || !OwningComp || !OwningComp->HasAuthority())
+	{
+		return;
+	}
+
+	//Derive the seed instead of rolling it so clients predicting this chunk pick the same lines
+	if (!bRetryingPendingChunk)
+	{
+		ChunkSeed = MakeNextChunkSeed(PlayerNode);
+	}
+
+	bool bNextReplyPending = false;
+	bool bGeneratedChunk = false;
+
+	//If we already worked this chunk out while the player was choosing and nothing has changed since, use that 
+	const FSpeculativeDialogueChunk* SpeculativeChunk = SpeculativeStateVersion == OwningComp->GetNarrativeStateVersion() ? SpeculativeChunks.Find(PlayerNode) : nullptr;
+
+	if (SpeculativeChunk && !bRetryingPendingChunk)
+	{
+		NPCReplyChain = SpeculativeChunk->NPCReplyChain;
+		AvailableResponses = SpeculativeChunk->AvailableResponses;
+		bChunkHasPendingConditions = false;
+		bGeneratedChunk = HasValidChunk();
+	}
+	else
+	{
+		//Find the first valid NPC reply after the option we selected
+		UDialogueNode_NPC* NextReply = FindNextNPCReply(PlayerNode, bNextReplyPending);
+		bGeneratedChunk = GenerateDialogueChunk(NextReply);
+	}
+
+	InvalidateSpeculativeChunks();
+
+	//If some latent conditions haven't finished, wait for them a bit rather than committing to a chunk that used the default 
+	if (bNextReplyPending || bChunkHasPendingConditions)
+	{
+		const UNarrativeDialogueSettings* DialogueSettings = GetDefault<UNarrativeDialogueSettings>();
+		const float WaitedTime = GetWorld() ? GetWorld()->GetTimeSeconds() - PendingChunkStartTime : 0.f;
+
+		if (GetWorld() && DialogueSettings && WaitedTime < DialogueSettings->PendingConditionTimeout)
+		{
+			PendingChunkPlayerNode = PlayerNode;
+			TimerHandle_PendingChunk = GetWorld()->GetTimerManager().SetTimerForNextTick(this, &UDialogue::RetryPendingChunk);
+			return;
+		}
+
+		UE_LOG(LogNarrative, Verbose, TEXT("Latent conditions on dialogue %s didn't finish in time, using the pending condition default."), *GetNameSafe(this));
+	}
+
+	//If we can generate more dialogue from the reply that was selected, do so, otherwise exit dialogue 
+	if (bGeneratedChunk)
+	{
+		MarkChunkStart();
+
+		//If we're Party, inform all party members a new chunk has arrived to play
+		if (UNarrativePartyComponent* PartyComp = Cast<UNarrativePartyComponent>(OwningComp))//OwningComp->IsPartyComponent())
+		{
+			for (auto& PartyMember : PartyComp->GetPartyMembers())
+			{
+				if (PartyMember)
 				{
-					UE_LOG(LogNarrative, Warning, TEXT("No more chunks generated from response. Ending dialogue! "));
-					ExitDialogue();
+					PartyMember->ClientRecieveDialogueChunk(PackCurrentChunk());
 				}
 			}
 		}
+		else
+		{
+			//RPC the dialogue chunk to the client so it can play it
+			OwningComp->ClientRecieveDialogueChunk(PackCurrentChunk());
+		}
+
+		Play();
+	}
+	else
+	{
+		UE_LOG(LogNarrative, Warning, TEXT("No more chunks generated from response. Ending dialogue! "));
+		ExitDialogue();
+	}
+}
+
+void UDialogue::UpdateSpeculativeChunks()
+{
+	const UNarrativeDialogueSettings* DialogueSettings = GetDefault<UNarrativeDialogueSettings>();
+
+	if (!DialogueSettings || DialogueSettings->SpeculativeChunkBudgetMs <= 0.f)
+	{
+		return;
+	}
+
+	//Only speculate while the player is choosing their reply. Party members can change each others state, which we don't track 
+	if (bDeinitialized || !bBeganPlaying || !OwningComp || !OwningComp->HasAuthority() || IsPartyDialogue() || NPCReplyChain.Num() || !AvailableResponses.Num())
+	{
+		return;
+	}
+
+	//Something has changed since we speculated, so our chunks might be wrong 
+	if (SpeculativeStateVersion != OwningComp->GetNarrativeStateVersion())
+	{
+		InvalidateSpeculativeChunks();
+	}
+
+	const double EndTime = FPlatformTime::Seconds() + DialogueSettings->SpeculativeChunkBudgetMs / 1000.f;
+
+	for (auto& Option : AvailableResponses)
+	{
+		if (!Option || SpeculativeChunks.Contains(Option) || SpeculationSkipped.Contains(Option))
+		{
+			continue;
+		}
+
+		if (FPlatformTime::Seconds() >= EndTime)
+		{
+			break;
+		}
+
+		FSpeculativeDialogueChunk Chunk;
+
+		if (SpeculateChunk(Option, Chunk))
+		{
+			SpeculativeChunks.Add(Option, Chunk);
+		}
+		else
+		{
+			SpeculationSkipped.Add(Option);
+		}
+	}
+}
+
+bool UDialogue::SpeculateChunk(UDialogueNode_Player* Option, FSpeculativeDialogueChunk& OutChunk)
+{
+	//Events could change anything our conditions look at, so we can't know the chunk until they've actually run
+	if (!Option || !OwningComp || Option->Events.Num() || FindFunction(Option->OnPlayNodeFuncName) || !Option->NPCReplies.Num())
+	{
+		return false;
+	}
+
+	//Conditions can check whether the option has been played, so pretend it has while we look ahead 
+	const FString OptionID = Option->GetID().ToString();
+	OwningComp->AdjustTaskCountSilently(NAME_PlayDialogueNodeTask, OptionID, 1);
+
+	bool bPending = false;
+
+	if (UDialogueNode_NPC* NextReply = FindNextNPCReply(Option, bPending))
+	{
+		OutChunk.NPCReplyChain = NextReply->GetReplyChain(OwningController, OwningPawn, OwningComp, &bPending);
+
+		if (OutChunk.NPCReplyChain.Num())
+		{
+			if (UDialogueNode_NPC* LastNPCNode = OutChunk.NPCReplyChain.Last())
+			{
+				OutChunk.AvailableResponses = LastNPCNode->GetPlayerReplies(OwningController, OwningPawn, OwningComp, &bPending);
+			}
+		}
+	}
 
+	OwningComp->AdjustTaskCountSilently(NAME_PlayDialogueNodeTask, OptionID, -1);
+
+	//Latent conditions that haven't finished need a fresh look once the option is actually played
+	return !bPending && OutChunk.NPCReplyChain.Num() > 0;
+}
+
+void UDialogue::InvalidateSpeculativeChunks()
+{
+	SpeculativeChunks.Empty();
+	SpeculationSkipped.Empty();
+	SpeculativeStateVersion = OwningComp ? OwningComp->GetNarrativeStateVersion() : 0;
+}
+
+void UDialogue::RetryPendingChunk()
+{
+	if (!bDeinitialized && PendingChunkPlayerNode)
+	{
+		GenerateNextChunk(PendingChunkPlayerNode);
 	}
 }
 
@@ -1374,6 +2126,172 @@ TArray<FName> UDialogue::MakeIDsFromPlayerNodes(const TArray<UDialogueNode_Playe
 	return IDs;
 }
 
+void UDialogue::MarkChunkStart()
+{
+	ChunkStartID = NPCReplyChain.IsValidIndex(0) && NPCReplyChain[0] ? NPCReplyChain[0]->GetID() : NAME_None;
+	ChunkLinesPlayed = 0;
+}
+
+FNarrativeDialogueCursor UDialogue::MakeCursor() const
+{
+	FNarrativeDialogueCursor Cursor;
+
+	Cursor.DialogueClass = GetClass();
+	Cursor.ChunkStartID = ChunkStartID;
+	Cursor.ChunkLinesPlayed = ChunkLinesPlayed;
+	Cursor.ChunkSeed = ChunkSeed;
+	Cursor.SelectedReplyIDs = SelectedReplyIDs;
+
+	return Cursor;
+}
+
+bool UDialogue::RestoreCursor(const FNarrativeDialogueCursor& Cursor)
+{
+	if (!Cursor.IsValid() || Cursor.ChunkStartID != ChunkStartID)
+	{
+		return false;
+	}
+
+	//Use the same seed as before so the lines still to come are the same variants the player would have heard
+	ChunkSeed = Cursor.ChunkSeed;
+
+	//Lines that had already finished aren't played again. If they all had, the player goes straight to picking a reply
+	ChunkLinesPlayed = FMath::Clamp(Cursor.ChunkLinesPlayed, 0, NPCReplyChain.Num());
+	NPCReplyChain.RemoveAt(0, ChunkLinesPlayed);
+
+	SelectedReplyIDs = Cursor.SelectedReplyIDs;
+
+	return true;
+}
+
+FPackedDialogueChunk UDialogue::PackCurrentChunk() const
+{
+	FPackedDialogueChunk Chunk;
+
+	Chunk.ChunkSeed = ChunkSeed;
+	Chunk.NodeTableChecksum = NodeTableChecksum;
+	Chunk.NPCReplyIndices.Reserve(NPCReplyChain.Num());
+	Chunk.PlayerReplyIndices.Reserve(AvailableResponses.Num());
+
+	for (auto& Node : NPCReplyChain)
+	{
+		const int32 Index = NPCReplies.IndexOfByKey(Node);
+
+		if (Index != INDEX_NONE)
+		{
+			Chunk.NPCReplyIndices.Add(Index);
+		}
+	}
+
+	for (auto& Node : AvailableResponses)
+	{
+		const int32 Index = PlayerReplies.IndexOfByKey(Node);
+
+		if (Index != INDEX_NONE)
+		{
+			Chunk.PlayerReplyIndices.Add(Index);
+		}
+	}
+
+	return Chunk;
+}
+
+FPackedDialogueOption UDialogue::PackOption(const UDialogueNode_Player* Option) const
+{
+	FPackedDialogueOption PackedOption;
+
+	PackedOption.OptionIndex = PlayerReplies.IndexOfByKey(Option);
+	PackedOption.NodeTableChecksum = NodeTableChecksum;
+
+	return PackedOption;
+}
+
+UDialogueNode_Player* UDialogue::UnpackOption(const FPackedDialogueOption& PackedOption) const
+{
+	if (PackedOption.NodeTableChecksum != NodeTableChecksum)
+	{
+		UE_LOG(LogNarrative, Error, TEXT("Dialogue %s received an option from a different version of the dialogue (checksum %u, expected %u)."), *GetNameSafe(this), PackedOption.NodeTableChecksum, NodeTableChecksum);
+		return nullptr;
+	}
+
+	return PlayerReplies.IsValidIndex(PackedOption.OptionIndex) ? PlayerReplies[PackedOption.OptionIndex] : nullptr;
+}
+
+void UDialogue::BakeNodeTableChecksum()
+{
+	uint32 Checksum = 0;
+
+	//FNames can have different casing in different processes, so lowercase the IDs so client and server always agree
+	auto HashNodes = [&Checksum](const auto& Nodes)
+	{
+		const int32 NumNodes = Nodes.Num();
+		Checksum = FCrc::MemCrc32(&NumNodes, sizeof(NumNodes), Checksum);
+
+		for (auto& Node : Nodes)
+		{
+			Checksum = FCrc::StrCrc32(Node ? *Node->GetID().ToString().ToLower() : TEXT(""), Checksum);
+		}
+	};
+
+	HashNodes(NPCReplies);
+	HashNodes(PlayerReplies);
+
+	//Zero means no checksum has been baked
+	NodeTableChecksum = Checksum ? Checksum : 1;
+}
+
+//Sending a huge count would make the receiver allocate a huge array, so reject anything no dialogue could ever need
+static const uint32 MaxPackedDialogueNodes = 4096;
+
+static void SerializePackedNodeIndices(FArchive& Ar, TArray<int32>& Indices)
+{
+	uint32 NumIndices = Indices.Num();
+	Ar.SerializeIntPacked(NumIndices);
+
+	if (Ar.IsLoading())
+	{
+		if (NumIndices > MaxPackedDialogueNodes)
+		{
+			Ar.SetError();
+			return;
+		}
+
+		Indices.SetNumUninitialized(NumIndices);
+	}
+
+	for (int32& Index : Indices)
+	{
+		uint32 PackedIndex = (uint32)Index;
+		Ar.SerializeIntPacked(PackedIndex);
+		Index = (int32)PackedIndex;
+	}
+}
+
+bool FPackedDialogueChunk::NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
+{
+	Ar << NodeTableChecksum;
+	Ar << ChunkSeed;
+
+	SerializePackedNodeIndices(Ar, NPCReplyIndices);
+	SerializePackedNodeIndices(Ar, PlayerReplyIndices);
+
+	bOutSuccess = !Ar.IsError();
+	return true;
+}
+
+bool FPackedDialogueOption::NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
+{
+	Ar << NodeTableChecksum;
+
+	//Offset by one so INDEX_NONE packs down to a single byte
+	uint32 PackedIndex = (uint32)(OptionIndex + 1);
+	Ar.SerializeIntPacked(PackedIndex);
+	OptionIndex = (int32)PackedIndex - 1;
+
+	bOutSuccess = !Ar.IsError();
+	return true;
+}
+
 TArray<UDialogueNode*> UDialogue::GetNodes() const
 {
 	TArray<UDialogueNode*> Ret;
@@ -1407,7 +2325,15 @@ AActor* UDialogue::LinkSpeakerAvatar_Implementation(const FSpeakerInfo& Info)
 
 			if (UWorld* World = GetWorld())
 			{
-				SpawnedActor = World->SpawnActor(Info.SpeakerAvatarClass, &Info.SpeakerAvatarTransform, SpawnParams);
+				//Grab an avatar from the pool if we can, the pool will spawn one if it doesn't have any free
+				if (UNarrativeDialoguePool* DialoguePool = World->GetSubsystem<UNarrativeDialoguePool>())
+				{
+					SpawnedActor = DialoguePool->AcquireAvatar(Info.SpeakerAvatarClass, Info.SpeakerAvatarTransform, OwningController);
+				}
+				else
+				{
+					SpawnedActor = World->SpawnActor(Info.SpeakerAvatarClass, &Info.SpeakerAvatarTransform, SpawnParams);
+				}
 			}
 		}
 		else
@@ -1415,13 +2341,22 @@ AActor* UDialogue::LinkSpeakerAvatar_Implementation(const FSpeakerInfo& Info)
 			//If the user doesn't want narrative to spawn their dialogue avatar, search the world an actor tagged with the Speakers ID
 			TArray<AActor*> FoundActors;
 
-			for (FActorIterator It(GetWorld()); It; ++It)
-			{
-				AActor* Actor = *It;
+			UWorld* World = GetWorld();
 
-				if (Actor && Actor->ActorHasTag(Info.SpeakerID))
+			if (UNarrativeActorRegistry* ActorRegistry = World ? World->GetSubsystem<UNarrativeActorRegistry>() : nullptr)
+			{
+				ActorRegistry->GetActorsWithTag(Info.SpeakerID, FoundActors);
+			}
+			else
+			{
+				for (FActorIterator It(World); It; ++It)
 				{
-					FoundActors.Add(Actor);
+					AActor* Actor = *It;
+
+					if (Actor && Actor->ActorHasTag(Info.SpeakerID))
+					{
+						FoundActors.Add(Actor);
+					}
 				}
 			}
 
@@ -1449,7 +2384,16 @@ void UDialogue::DestroySpeakerAvatar_Implementation(const FSpeakerInfo& Info, AA
 	//Also, don't remove any speaker avatars unless narrative spawned them. If they were already in the world they shouldn't get deleted 
 	if (SpeakerAvatar != OwningPawn && IsValid(Info.SpeakerAvatarClass))
 	{
-		SpeakerAvatar->Destroy();
+		UWorld* World = GetWorld();
+
+		if (UNarrativeDialoguePool* DialoguePool = World ? World->GetSubsystem<UNarrativeDialoguePool>() : nullptr)
+		{
+			DialoguePool->ReleaseAvatar(SpeakerAvatar);
+		}
+		else
+		{
+			SpeakerAvatar->Destroy();
+		}
 	}
 }
 
@@ -1459,20 +2403,18 @@ void UDialogue::PlayDialogueAnimation_Implementation(class UDialogueNode* Node,
 
 	if (ActorToUse)
 	{ 
+		FSpeakerAvatarMeshes& Meshes = GetSpeakerAvatarMeshes(ActorToUse);
+
 		///Play a facial anim if one is set 
-		if(Line.FacialAnimation)
+		if(UAnimMontage* FacialAnimation = Line.GetFacialAnimation())
 		{
-			TArray<UActorComponent*> FaceMeshes = ActorToUse->GetComponentsByTag(USkeletalMeshComponent::StaticClass(), NAME_FaceTag);
-			if (FaceMeshes.Num())
+			if (Meshes.FaceMeshes.Num())
 			{
-				for (UActorComponent* FaceAC : FaceMeshes)
+				for (FSpeakerMeshCache& FaceMesh : Meshes.FaceMeshes)
 				{
-					if (USkeletalMeshComponent* FaceMesh = Cast<USkeletalMeshComponent>(FaceAC))
+					if (UAnimInstance* FaceAnimInstance = FaceMesh.GetAnimInstance())
 					{
-						if (FaceMesh->GetAnimInstance())
-						{
-							FaceMesh->GetAnimInstance()->Montage_Play(Line.FacialAnimation);
-						}
+						FaceAnimInstance->Montage_Play(FacialAnimation);
 					}
 				}
 			}
@@ -1482,20 +2424,15 @@ void UDialogue::PlayDialogueAnimation_Implementation(class UDialogueNode* Node,
 			}
 		}
 
-		if (Line.DialogueMontage)
+		if (UAnimMontage* DialogueMontage = Line.GetDialogueMontage())
 		{
-			TArray<UActorComponent*> BodyMeshes = ActorToUse->GetComponentsByTag(USkeletalMeshComponent::StaticClass(), NAME_BodyTag);
-
-			if (BodyMeshes.Num())
+			if (Meshes.BodyMeshes.Num())
 			{
-				for (UActorComponent* BodyAC : BodyMeshes)
+				for (FSpeakerMeshCache& BodyMesh : Meshes.BodyMeshes)
 				{
-					if (USkeletalMeshComponent* BodyMesh = Cast<USkeletalMeshComponent>(BodyAC))
+					if (UAnimInstance* BodyAnimInstance = BodyMesh.GetAnimInstance())
 					{
-						if (BodyMesh->GetAnimInstance())
-						{
-							BodyMesh->GetAnimInstance()->Montage_Play(Line.DialogueMontage);
-						}
+						BodyAnimInstance->Montage_Play(DialogueMontage);
 					}
 				}
 			}
@@ -1512,20 +2449,20 @@ void UDialogue::StopDialogueAnimation_Implementation()
 
 	if (CurrentSpeakerAvatar)
 	{
-		if (CurrentLine.FacialAnimation)
+		FSpeakerAvatarMeshes& Meshes = GetSpeakerAvatarMeshes(CurrentSpeakerAvatar);
+
+		//If the montage isn't loaded it can't be playing, so no need to load it just to stop it
+		if (UAnimMontage* FacialAnimation = CurrentLine.FacialAnimation.Get())
 		{
-			TArray<UActorComponent*> FaceMeshes = CurrentSpeakerAvatar->GetComponentsByTag(USkeletalMeshComponent::StaticClass(), NAME_FaceTag);
-			if (FaceMeshes.Num())
+			if (Meshes.FaceMeshes.Num())
 			{
-				for (UActorComponent* FaceAC : FaceMeshes)
+				const float BlendOutTime = FacialAnimation->BlendOut.GetBlendTime();
+
+				for (FSpeakerMeshCache& FaceMesh : Meshes.FaceMeshes)
 				{
-					if (USkeletalMeshComponent* FaceMesh = Cast<USkeletalMeshComponent>(FaceAC))
+					if (UAnimInstance* FaceAnimInstance = FaceMesh.GetAnimInstance())
 					{
-						if (FaceMesh->GetAnimInstance())
-						{
-							const float BlendOutTime = CurrentLine.FacialAnimation->BlendOut.GetBlendTime();
-							FaceMesh->GetAnimInstance()->Montage_Stop(BlendOutTime, CurrentLine.FacialAnimation);
-						}
+						FaceAnimInstance->Montage_Stop(BlendOutTime, FacialAnimation);
 					}
 				}
 			}
@@ -1535,21 +2472,17 @@ void UDialogue::StopDialogueAnimation_Implementation()
 			}
 		}
 
-		if (CurrentLine.DialogueMontage)
+		if (UAnimMontage* DialogueMontage = CurrentLine.DialogueMontage.Get())
 		{
-			TArray<UActorComponent*> BodyMeshes = CurrentSpeakerAvatar->GetComponentsByTag(USkeletalMeshComponent::StaticClass(), NAME_BodyTag);
-
-			if (BodyMeshes.Num())
+			if (Meshes.BodyMeshes.Num())
 			{
-				for (UActorComponent* BodyAC : BodyMeshes)
+				const float BlendOutTime = DialogueMontage->BlendOut.GetBlendTime();
+
+				for (FSpeakerMeshCache& BodyMesh : Meshes.BodyMeshes)
 				{
-					if (USkeletalMeshComponent* BodyMesh = Cast<USkeletalMeshComponent>(BodyAC))
+					if (UAnimInstance* BodyAnimInstance = BodyMesh.GetAnimInstance())
 					{
-						if (BodyMesh->GetAnimInstance())
-						{
-							const float BlendOutTime = CurrentLine.DialogueMontage->BlendOut.GetBlendTime();
-							BodyMesh->GetAnimInstance()->Montage_Stop(BlendOutTime, CurrentLine.DialogueMontage);
-						}
+						BodyAnimInstance->Montage_Stop(BlendOutTime, DialogueMontage);
 					}
 				}
 			}
@@ -1569,25 +2502,83 @@ void UDialogue::PlayDialogueSound_Implementation(const FDialogueLine& Line, clas
 		//Remove any previously added bindings
 		DialogueAudio->OnAudioFinished.RemoveAll(this);
 		DialogueAudio->Stop();
-		DialogueAudio->DestroyComponent();
 	}
 
-	if (Line.DialogueSound)
+	if (USoundBase* DialogueSound = Line.GetDialogueSound())
 	{
-		if (Speaker)
+		DialogueAudio = GetSpeakerAudioComponent(DialogueSound, Speaker);
+
+		if (DialogueAudio)
 		{
-			DialogueAudio = UGameplayStatics::SpawnSoundAtLocation(OwningComp, Line.DialogueSound, Speaker->GetActorLocation(), Speaker->GetActorForwardVector().Rotation());
+			DialogueAudio->SetSound(DialogueSound);
+			DialogueAudio->Play();
+
+			if (Line.Duration == ELineDuration::LD_WhenAudioEnds)
+			{
+				DialogueAudio->OnAudioFinished.AddDynamic(this, &UDialogue::EndCurrentLine);
+			}
 		}
-		else //Else just play 2D audio 
+	}
+}
+
+UAudioComponent* UDialogue::GetSpeakerAudioComponent(USoundBase* Sound, AActor* Speaker)
+{
+	if (Speaker && Speaker->GetRootComponent())
+	{
+		UAudioComponent* SpeakerAudio = SpeakerAudioComponents.FindRef(Speaker);
+
+		//Component may have been destroyed along with the speaker, or if the speaker was released back to the pool
+		if (!IsValid(SpeakerAudio))
 		{
-			DialogueAudio = UGameplayStatics::SpawnSound2D(OwningComp, Line.DialogueSound);
+			//Make the component ourselves rather than via SpawnSoundAttached, which would start playing the sound only for us to stop it again.
+			//Attach it so it follows the speaker around, and don't auto destroy it as we'll reuse it for the speakers next line
+			SpeakerAudio = NewObject<UAudioComponent>(Speaker);
+			SpeakerAudio->bAutoActivate = false;
+			SpeakerAudio->bAutoDestroy = false;
+			SpeakerAudio->SetSound(Sound);
+			SpeakerAudio->SetupAttachment(Speaker->GetRootComponent());
+			SpeakerAudio->RegisterComponent();
+
+			SpeakerAudioComponents.Add(Speaker, SpeakerAudio);
 		}
 
-		if (DialogueAudio && Line.Duration == ELineDuration::LD_WhenAudioEnds)
+		return SpeakerAudio;
+	}
+
+	//Else just play 2D audio 
+	if (!IsValid(DialogueAudio2D))
+	{
+		DialogueAudio2D = UGameplayStatics::CreateSound2D(OwningComp, Sound, 1.f, 1.f, 0.f, nullptr, false, false);
+	}
+
+	return DialogueAudio2D;
+}
+
+void UDialogue::CleanupDialogueAudio()
+{
+	if (DialogueAudio)
+	{
+		DialogueAudio->OnAudioFinished.RemoveAll(this);
+	}
+
+	for (auto& SpeakerAudioKVP : SpeakerAudioComponents)
+	{
+		if (IsValid(SpeakerAudioKVP.Value))
 		{
-			DialogueAudio->OnAudioFinished.AddDynamic(this, &UDialogue::EndCurrentLine);
+			SpeakerAudioKVP.Value->Stop();
+			SpeakerAudioKVP.Value->DestroyComponent();
 		}
 	}
+
+	if (IsValid(DialogueAudio2D))
+	{
+		DialogueAudio2D->Stop();
+		DialogueAudio2D->DestroyComponent();
+	}
+
+	SpeakerAudioComponents.Empty();
+	DialogueAudio2D = nullptr;
+	DialogueAudio = nullptr;
 }
 
 void UDialogue::PlayDialogueNode_Implementation(class UDialogueNode* Node, const FDialogueLine& Line, const FSpeakerInfo& Speaker, class AActor* SpeakerActor, class AActor* ListenerActor)
@@ -1745,14 +2736,21 @@ void UDialogue::PlayDialogueSequence(class UNarrativeDialogueSequence* Sequence,
 		AActor* PAvatar = GetPlayerAvatar();
 		const bool bAvatarHidden = PAvatar ? PAvatar->IsHidden() : false;
 
-		//Narrative needs to initialize its cutscene player 
+		//Narrative needs to initialize its cutscene player - borrow one from the pool if we can so we don't need to spawn one
 		if (!DialogueSequencePlayer)
 		{
-			ULevelSequencePlayer::CreateLevelSequencePlayer(GetWorld(), Sequence->GetSequenceAssets().Last(), Sequence->GetPlaybackSettings(), DialogueSequencePlayer);
-			//passing CreateLevelSequencePlayer null asset makes it fail so we need to set it afterwards
-			if (DialogueSequencePlayer)
+			if (UNarrativeDialoguePool* DialoguePool = GetWorld() ? GetWorld()->GetSubsystem<UNarrativeDialoguePool>() : nullptr)
+			{
+				DialogueSequencePlayer = DialoguePool->AcquireSequenceActor(Sequence->GetPlaybackSettings());
+			}
+			else
 			{
-				DialogueSequencePlayer->SetSequence(nullptr);
+				ULevelSequencePlayer::CreateLevelSequencePlayer(GetWorld(), Sequence->GetSequenceAssets().Last(), Sequence->GetPlaybackSettings(), DialogueSequencePlayer);
+				//passing CreateLevelSequencePlayer null asset makes it fail so we need to set it afterwards
+				if (DialogueSequencePlayer)
+				{
+					DialogueSequencePlayer->SetSequence(nullptr);
+				}
 			}
 		}
 
@@ -1782,6 +2780,147 @@ void UDialogue::PlayDialogueSequence(class UNarrativeDialogueSequence* Sequence,
 
 	}
 }
+void UDialogue::ReleaseDialogueSequencePlayer()
+{
+	if (DialogueSequencePlayer)
+	{
+		if (DialogueSequencePlayer->SequencePlayer)
+		{
+			DialogueSequencePlayer->SequencePlayer->OnFinished.RemoveAll(this);
+		}
+
+		if (UNarrativeDialoguePool* DialoguePool = GetWorld() ? GetWorld()->GetSubsystem<UNarrativeDialoguePool>() : nullptr)
+		{
+			DialoguePool->ReleaseSequenceActor(DialogueSequencePlayer);
+		}
+		else
+		{
+			if (DialogueSequencePlayer->SequencePlayer)
+			{
+				DialogueSequencePlayer->SequencePlayer->Stop();
+			}
+
+			DialogueSequencePlayer->Destroy();
+		}
+
+		DialogueSequencePlayer = nullptr;
+	}
+}
+
+void UDialogue::UpdateMediaPrefetch()
+{
+	UWorld* World = GetWorld();
+
+	//Dedicated servers never play any dialogue media, so don't stream anything in 
+	if (!World || World->GetNetMode() == NM_DedicatedServer || !UAssetManager::IsValid())
+	{
+		return;
+	}
+
+	const UNarrativeDialogueSettings* DialogueSettings = GetDefault<UNarrativeDialogueSettings>();
+	const int32 LinesToPrefetch = DialogueSettings ? DialogueSettings->DialogueMediaPrefetchLines : 0;
+
+	//Walk outwards from the current line breadth first, so the lines that could play soonest are requested first
+	TArray<UDialogueNode*> NodesToVisit;
+	TSet<UDialogueNode*> VisitedNodes;
+
+	if (CurrentNode)
+	{
+		NodesToVisit.Add(CurrentNode);
+	}
+
+	NodesToVisit.Append(NPCReplyChain);
+	NodesToVisit.Append(AvailableResponses);
+
+	TArray<FSoftObjectPath> ReachableMedia;
+
+	//+1 since the current line doesn't count towards the look ahead 
+	for (int32 i = 0; i < NodesToVisit.Num() && VisitedNodes.Num() < LinesToPrefetch + 1; ++i)
+	{
+		UDialogueNode* Node = NodesToVisit[i];
+
+		if (!Node || VisitedNodes.Contains(Node))
+		{
+			continue;
+		}
+
+		VisitedNodes.Add(Node);
+
+		Node->Line.GetMediaPaths(ReachableMedia);
+
+		for (auto& AltLine : Node->AlternativeLines)
+		{
+			AltLine.GetMediaPaths(ReachableMedia);
+		}
+
+		NodesToVisit.Append(Node->NPCReplies);
+		NodesToVisit.Append(Node->PlayerReplies);
+	}
+
+	const TSet<FSoftObjectPath> ReachableMediaSet(ReachableMedia);
+
+	//Let go of anything that can no longer be reached 
+	for (auto It = PrefetchedMedia.CreateIterator(); It; ++It)
+	{
+		if (!ReachableMediaSet.Contains(It.Key()))
+		{
+			if (It.Value().IsValid())
+			{
+				It.Value()->ReleaseHandle();
+			}
+
+			It.RemoveCurrent();
+		}
+	}
+
+	//Request anything we haven't already, in the order we found it
+	FStreamableManager& StreamableManager = UAssetManager::GetStreamableManager();
+
+	for (const FSoftObjectPath& MediaPath : ReachableMedia)
+	{
+		if (!PrefetchedMedia.Contains(MediaPath))
+		{
+			PrefetchedMedia.Add(MediaPath, StreamableManager.RequestAsyncLoad(MediaPath, FStreamableDelegate(), FStreamableManager::AsyncLoadHighPriority));
+		}
+	}
+
+	if (CVarLogDialogueMediaResidency.GetValueOnGameThread())
+	{
+		const FDialogueMediaResidency Residency = GetMediaResidency();
+		UE_LOG(LogNarrative, Display, TEXT("Dialogue %s media: %d prefetched, %d resident, %.2f MB"), *GetNameSafe(this), Residency.PrefetchedAssets, Residency.ResidentAssets, Residency.ResidentBytes / (1024.f * 1024.f));
+	}
+}
+
+void UDialogue::ReleasePrefetchedMedia()
+{
+	for (auto& MediaKVP : PrefetchedMedia)
+	{
+		if (MediaKVP.Value.IsValid())
+		{
+			MediaKVP.Value->ReleaseHandle();
+		}
+	}
+
+	PrefetchedMedia.Empty();
+}
+
+FDialogueMediaResidency UDialogue::GetMediaResidency() const
+{
+	FDialogueMediaResidency Residency;
+	Residency.PrefetchedAssets = PrefetchedMedia.Num();
+
+	for (auto& MediaKVP : PrefetchedMedia)
+	{
+		if (UObject* Media = MediaKVP.Key.ResolveObject())
+		{
+			++Residency.ResidentAssets;
+			Residency.ResidentBytes += Media->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal);
+		}
+	}
+
+	return Residency;
+}
+
 void UDialogue::StopDialogueSequence()
 {
 	if (OwningController && OwningController->IsLocalPlayerController())
@@ -14,10 +14,231 @@
 #include "LevelSequencePlayer.h"
 #include "LevelSequenceActor.h"
 #include "Sound/SoundBase.h"
+#include "Animation/AnimMontage.h"
 #include "NarrativePartyComponent.h"
+#include "Async/ParallelFor.h"
+#include "AssetRegistry/AssetRegistryModule.h"
 
 #define LOCTEXT_NAMESPACE "DialogueSM"
 
+static TAutoConsoleVariable<bool> CVarParallelConditions(
+	TEXT("narrative.ParallelConditions"),
+	true,
+	TEXT("Allow dialogue nodes with lots of replies to check thread safe conditions in parallel.\n")
+);
+
+/**Check the conditions on a set of replies. Results are written out in the same order as the replies so filtering stays deterministic. 
+If there are enough replies and all their conditions are thread safe we'll fan out across the task graph, otherwise we go serially. */
+template<typename NodeType>
+static void EvaluateReplyConditions(const TArray<NodeType*>& Replies, APlayerController* OwningController, APawn* OwningPawn, class UNarrativeComponent* NarrativeComponent, TArray<ENarrativeConditionResult>& OutResults)
+{
+	OutResults.SetNumUninitialized(Replies.Num());
+
+	bool bCanRunParallel = CVarParallelConditions.GetValueOnGameThread() && FApp::ShouldUseThreadingForPerformance();
+
+	if (bCanRunParallel)
+	{
+		const UNarrativeDialogueSettings* DialogueSettings = GetDefault<UNarrativeDialogueSettings>();
+		bCanRunParallel = DialogueSettings && Replies.Num() >= DialogueSettings->ParallelConditionReplyThreshold;
+	}
+
+	//Party conditions have to be ran against each party member, which only the game thread path supports
+	if (bCanRunParallel)
+	{
+		bCanRunParallel = !Cast<UNarrativePartyComponent>(NarrativeComponent);
+	}
+
+	if (bCanRunParallel)
+	{
+		for (const NodeType* Reply : Replies)
+		{
+			if (Reply && !Reply->AreConditionsThreadSafe())
+			{
+				bCanRunParallel = false;
+				break;
+			}
+		}
+	}
+
+	if (bCanRunParallel)
+	{
+		ParallelFor(Replies.Num(), [&](int32 Idx)
+		{
+			NodeType* Reply = Replies[Idx];
+			OutResults[Idx] = Reply ? Reply->EvaluateConditionsThreadSafe(OwningPawn, OwningController, NarrativeComponent) : ENarrativeConditionResult::Failed;
+		});
+	}
+	else
+	{
+		for (int32 Idx = 0; Idx < Replies.Num(); ++Idx)
+		{
+			NodeType* Reply = Replies[Idx];
+			OutResults[Idx] = Reply ? Reply->EvaluateConditions(OwningPawn, OwningController, NarrativeComponent) : ENarrativeConditionResult::Failed;
+		}
+	}
+}
+
+//Resolve a soft media reference on a line. The prefetcher should have already loaded it, if not we have no choice but to load it now
+template<typename MediaType>
+static MediaType* ResolveLineMedia(const TSoftObjectPtr<MediaType>& Media)
+{
+	if (Media.IsNull())
+	{
+		return nullptr;
+	}
+
+	if (MediaType* LoadedMedia = Media.Get())
+	{
+		return LoadedMedia;
+	}
+
+	UE_LOG(LogNarrative, Verbose, TEXT("Dialogue media %s wasn't prefetched and had to be loaded synchronously."), *Media.ToString());
+	return Media.LoadSynchronous();
+}
+
+USoundBase* FDialogueLine::GetDialogueSound() const
+{
+	return ResolveLineMedia(DialogueSound);
+}
+
+UAnimMontage* FDialogueLine::GetDialogueMontage() const
+{
+	return ResolveLineMedia(DialogueMontage);
+}
+
+UAnimMontage* FDialogueLine::GetFacialAnimation() const
+{
+	return ResolveLineMedia(FacialAnimation);
+}
+
+void FDialogueLine::GetMediaPaths(TArray<FSoftObjectPath>& OutPaths) const
+{
+	if (!DialogueSound.IsNull())
+	{
+		OutPaths.Add(DialogueSound.ToSoftObjectPath());
+	}
+
+	if (!DialogueMontage.IsNull())
+	{
+		OutPaths.Add(DialogueMontage.ToSoftObjectPath());
+	}
+
+	if (!FacialAnimation.IsNull())
+	{
+		OutPaths.Add(FacialAnimation.ToSoftObjectPath());
+	}
+}
+
+void FDialogueLine::BakeHasShot()
+{
+	bHasShot = Shot != nullptr;
+}
+
+void FDialogueLine::BakeSoundDuration(const bool bAllowLoad)
+{
+	if (DialogueSound.IsNull())
+	{
+		BakedSoundDuration = -1.f;
+		return;
+	}
+
+	//A sound that's already loaded can just tell us its length
+	if (const USoundBase* Sound = DialogueSound.Get())
+	{
+		BakedSoundDuration = Sound->GetDuration();
+		return;
+	}
+
+	//Sound waves store their length in the asset registry, so we can usually read it without loading the sound
+	FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry"));
+	const FAssetData SoundData = AssetRegistryModule.Get().GetAssetByObjectPath(DialogueSound.ToSoftObjectPath());
+
+	float RegistryDuration = 0.f;
+
+	if (SoundData.IsValid() && SoundData.GetTagValue(TEXT("Duration"), RegistryDuration))
+	{
+		BakedSoundDuration = RegistryDuration;
+		return;
+	}
+
+	//Otherwise keep what we baked last time unless we're allowed to load the sound, ie when compiling 
+	if (bAllowLoad)
+	{
+		const USoundBase* Sound = DialogueSound.LoadSynchronous();
+		BakedSoundDuration = Sound ? Sound->GetDuration() : -1.f;
+	}
+}
+
+bool FDialogueLine::HasShot() const
+{
+#if WITH_EDITOR
+	//Shots are never stripped in the editor, and bHasShot may be stale until the dialogue is next compiled
+	return Shot != nullptr;
+#else
+	return Shot != nullptr || bHasShot;
+#endif
+}
+
+float FDialogueLine::GetSoundDuration() const
+{
+	if (DialogueSound.IsNull())
+	{
+		return -1.f;
+	}
+
+	if (BakedSoundDuration >= 0.f)
+	{
+		return BakedSoundDuration;
+	}
+
+	//Dialogue hasn't been recompiled since durations were baked, so we've no choice but to load the sound 
+	const USoundBase* Sound = GetDialogueSound();
+	return Sound ? Sound->GetDuration() : -1.f;
+}
+
+bool FDialogueLine::TokenizeString(const FString& InString, TArray<FDialogueTextSegment>& OutSegments)
+{
+	OutSegments.Reset();
+
+	bool bFoundVariable = false;
+	int32 LiteralStart = 0;
+	int32 SearchIdx = 0;
+
+	while (SearchIdx < InString.Len())
+	{
+		const int32 OpenBraceIdx = InString.Find(TEXT("{"), ESearchCase::CaseSensitive, ESearchDir::FromStart, SearchIdx);
+
+		if (OpenBraceIdx == INDEX_NONE)
+		{
+			break;
+		}
+
+		const int32 CloseBraceIdx = InString.Find(TEXT("}"), ESearchCase::CaseSensitive, ESearchDir::FromStart, OpenBraceIdx + 1);
+
+		if (CloseBraceIdx == INDEX_NONE)
+		{
+			break;
+		}
+
+		if (OpenBraceIdx > LiteralStart)
+		{
+			OutSegments.Emplace(InString.Mid(LiteralStart, OpenBraceIdx - LiteralStart), false);
+		}
+
+		OutSegments.Emplace(InString.Mid(OpenBraceIdx + 1, CloseBraceIdx - OpenBraceIdx - 1), true);
+		bFoundVariable = true;
+
+		LiteralStart = SearchIdx = CloseBraceIdx + 1;
+	}
+
+	if (LiteralStart < InString.Len())
+	{
+		OutSegments.Emplace(InString.Mid(LiteralStart), false);
+	}
+
+	return bFoundVariable;
+}
+
 UDialogueNode::UDialogueNode()
 {
 
@@ -27,23 +248,40 @@ UDialogueNode::UDialogueNode()
 
 FDialogueLine UDialogueNode::GetRandomLine(const bool bStandalone) const
 {
-	FDialogueLine NewLine = Line;
+	return GetSeededLine(bStandalone, FMath::Rand());
+}
 
-	//Construct the line instead of adding it as a member as to not break dialogues made pre 2.2
-	if (AlternativeLines.Num())
+int32 UDialogueNode::GetLineVariantIndex(const int32 Seed) const
+{
+	if (!AlternativeLines.Num())
 	{
-		TArray<FDialogueLine> AllLines = AlternativeLines;
-		AllLines.Add(Line);
-		NewLine = AllLines[FMath::RandRange(0, AllLines.Num() - 1)];
+		return INDEX_NONE;
 	}
 
+	//Mix our ID into the seed so nodes in the same chunk don't all pick the same variant index 
+	const FRandomStream VariantStream(HashCombine(GetTypeHash(Seed), GetStableIDHash()));
+	const int32 Roll = VariantStream.RandRange(0, AlternativeLines.Num());
+
+	//The main line and each alternative line are all equally likely 
+	return Roll < AlternativeLines.Num() ? Roll : INDEX_NONE;
+}
+
+const FDialogueLine& UDialogueNode::GetLineVariant(const int32 VariantIndex) const
+{
+	return AlternativeLines.IsValidIndex(VariantIndex) ? AlternativeLines[VariantIndex] : Line;
+}
+
+FDialogueLine UDialogueNode::GetSeededLine(const bool bStandalone, const int32 Seed) const
+{
+	FDialogueLine NewLine = GetLineVariant(GetLineVariantIndex(Seed));
+
 	if (NewLine.Duration == ELineDuration::LD_Default)
 	{
-		if (NewLine.DialogueSound)
+		if (!NewLine.DialogueSound.IsNull())
 		{
 			NewLine.Duration = ELineDuration::LD_WhenAudioEnds;
 		}
-		else if (NewLine.Shot && NewLine.Text.IsEmptyOrWhitespace())
+		else if (NewLine.HasShot() && NewLine.Text.IsEmptyOrWhitespace())
 		{
 			NewLine.Duration = ELineDuration::LD_WhenSequenceEnds;
 		}
@@ -53,49 +291,72 @@ FDialogueLine UDialogueNode::GetRandomLine(const bool bStandalone) const
 		}
 	}
 
-	//The server doesn't receieve audio and sequence end events so it needs to use duration
+	//The server doesn't receieve audio and sequence end events so it needs to use duration. The duration is baked at cook time so the sound doesn't need loading
 	if (!bStandalone)
 	{
 		if (NewLine.Duration == ELineDuration::LD_WhenAudioEnds)
 		{
+			const float SoundDuration = NewLine.GetSoundDuration();
 			NewLine.Duration = ELineDuration::LD_AfterDuration;
-			NewLine.DurationSecondsOverride = NewLine.DialogueSound ? NewLine.DialogueSound->GetDuration() : 0.2f;
+			NewLine.DurationSecondsOverride = SoundDuration >= 0.f ? SoundDuration : 0.2f;
 		}
 		else if (NewLine.Duration == ELineDuration::LD_WhenSequenceEnds)
 		{
 			UE_LOG(LogNarrative, Warning, TEXT("When Sequence Ends duration isn't supported in networked games. Falling back to audio length. "));
+			const float SoundDuration = NewLine.GetSoundDuration();
 			NewLine.Duration = ELineDuration::LD_AfterDuration;
-			NewLine.DurationSecondsOverride = NewLine.DialogueSound ? NewLine.DialogueSound->GetDuration() : 0.2f;
+			NewLine.DurationSecondsOverride = SoundDuration >= 0.f ? SoundDuration : 0.2f;
 		}
 	}
 
 	return NewLine;
 }
 
-TArray<class UDialogueNode_NPC*> UDialogueNode::GetNPCReplies(APlayerController* OwningController, APawn* OwningPawn, class UNarrativeComponent* NarrativeComponent)
+TArray<class UDialogueNode_NPC*> UDialogueNode::GetNPCReplies(APlayerController* OwningController, APawn* OwningPawn, class UNarrativeComponent* NarrativeComponent, bool* bOutHasPendingConditions /*= nullptr*/)
 {
 	TArray<class UDialogueNode_NPC*> ValidReplies;
+	TArray<ENarrativeConditionResult> Results;
+
+	EvaluateReplyConditions(NPCReplies, OwningController, OwningPawn, NarrativeComponent, Results);
 
-	for (auto& NPCReply : NPCReplies)
+	for (int32 Idx = 0; Idx < NPCReplies.Num(); ++Idx)
 	{
-		if (NPCReply->AreConditionsMet(OwningPawn, OwningController, NarrativeComponent))
+		if (Results[Idx] == ENarrativeConditionResult::Pending && bOutHasPendingConditions)
 		{
-			ValidReplies.Add(NPCReply);
+			*bOutHasPendingConditions = true;
+		}
+
+		if (NPCReplies[Idx] && ResolveConditionResult(Results[Idx]))
+		{
+			ValidReplies.Add(NPCReplies[Idx]);
 		}
 	}
 
 	return ValidReplies;
 }
 
-TArray<class UDialogueNode_Player*> UDialogueNode::GetPlayerReplies(APlayerController* OwningController, APawn* OwningPawn, class UNarrativeComponent* NarrativeComponent)
+TArray<class UDialogueNode_Player*> UDialogueNode::GetPlayerReplies(APlayerController* OwningController, APawn* OwningPawn, class UNarrativeComponent* NarrativeComponent, bool* bOutHasPendingConditions /*= nullptr*/)
 {
 	TArray<class UDialogueNode_Player*> ValidReplies;
+	TArray<ENarrativeConditionResult> Results;
 
-	for (auto& PlayerReply : PlayerReplies)
+	EvaluateReplyConditions(PlayerReplies, OwningController, OwningPawn, NarrativeComponent, Results);
+
+	for (int32 Idx = 0; Idx < PlayerReplies.Num(); ++Idx)
 	{
-		if (PlayerReply && PlayerReply->AreConditionsMet(OwningPawn, OwningController, NarrativeComponent))
+		if (!PlayerReplies[Idx])
+		{
+			continue;
+		}
+
+		if (Results[Idx] == ENarrativeConditionResult::Pending && bOutHasPendingConditions)
+		{
+			*bOutHasPendingConditions = true;
+		}
+
+		if (ResolveConditionResult(Results[Idx]))
 		{
-			ValidReplies.Add(PlayerReply);
+			ValidReplies.Add(PlayerReplies[Idx]);
 		}
 	}
 
@@ -117,7 +378,7 @@ UWorld* UDialogueNode::GetWorld() const
 
 const bool UDialogueNode::IsMissingCues() const
 {
-	if (!Line.Text.IsEmpty() && !Line.DialogueSound)
+	if (!Line.Text.IsEmpty() && Line.DialogueSound.IsNull())
 	{
 		return true;
 	}
@@ -129,7 +390,7 @@ const bool UDialogueNode::IsMissingCues() const
 
 	for (auto& AltLine : AlternativeLines)
 	{
-		if (AltLine.Text.IsEmptyOrWhitespace() && !AltLine.DialogueSound)
+		if (AltLine.Text.IsEmptyOrWhitespace() && AltLine.DialogueSound.IsNull())
 		{
 			return true;
 		}
@@ -140,7 +401,7 @@ const bool UDialogueNode::IsMissingCues() const
 
 bool UDialogueNode::IsRoutingNode() const
 {
-	if (Line.Shot || Line.DialogueSound || Events.Num() || !Line.Text.IsEmptyOrWhitespace())
+	if (Line.HasShot() || !Line.DialogueSound.IsNull() || Events.Num() || !Line.Text.IsEmptyOrWhitespace())
 	{
 		return false;
 	}
@@ -148,8 +409,43 @@ bool UDialogueNode::IsRoutingNode() const
 	return true;
 }
 
+TSharedRef<const TArray<FDialogueTextSegment>> UDialogueNode::GetTextSegments(const FString& LineString) const
+{
+	if (const TSharedRef<const TArray<FDialogueTextSegment>>* CachedSegments = TextSegmentCache.Find(LineString))
+	{
+		return *CachedSegments;
+	}
+
+	TSharedRef<TArray<FDialogueTextSegment>> Segments = MakeShared<TArray<FDialogueTextSegment>>();
+	FDialogueLine::TokenizeString(LineString, *Segments);
+
+	TextSegmentCache.Add(LineString, Segments);
+	return Segments;
+}
+
+void UDialogueNode::BakeLineDurations(const bool bAllowLoad)
+{
+	Line.BakeHasShot();
+	Line.BakeSoundDuration(bAllowLoad);
+
+	for (FDialogueLine& AlternativeLine : AlternativeLines)
+	{
+		AlternativeLine.BakeHasShot();
+		AlternativeLine.BakeSoundDuration(bAllowLoad);
+	}
+}
+
 #if WITH_EDITOR
 
+void UDialogueNode::PreSave(FObjectPreSaveContext SaveContext)
+{
+	Super::PreSave(SaveContext);
+
+	//Sounds may have been reimported since the dialogue was compiled, so bake again on save/cook. Loading during PreSave isn't safe, and would 
+	//load every voice asset the dialogue references on every save, so only use sounds that are already loaded or listed in the asset registry
+	BakeLineDurations(false);
+}
+
 void UDialogueNode::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
 {
 	Super::PostEditChangeProperty(PropertyChangedEvent);
@@ -287,7 +583,7 @@ bool UDialogueNode::HasDefaultID() const
 #endif
 
 
-TArray<class UDialogueNode_NPC*> UDialogueNode_NPC::GetReplyChain(APlayerController* OwningController, APawn* OwningPawn, class UNarrativeComponent* NarrativeComponent)
+TArray<class UDialogueNode_NPC*> UDialogueNode_NPC::GetReplyChain(APlayerController* OwningController, APawn* OwningPawn, class UNarrativeComponent* NarrativeComponent, bool* bOutHasPendingConditions /*= nullptr*/)
 {
 	TArray<UDialogueNode_NPC*> NPCFollowUpReplies;
 	UDialogueNode_NPC* CurrentNode = this;
@@ -339,7 +635,19 @@ TArray<class UDialogueNode_NPC*> UDialogueNode_NPC::GetReplyChain(APlayerControl
 		//Find the next valid reply. We'll then repeat this cycle until we run out
 		for (auto& Reply : NPCRepliesToRet)
 		{
-			if (Reply != this && Reply->AreConditionsMet(OwningPawn, OwningController, NarrativeComponent))
+			if (Reply == this)
+			{
+				continue;
+			}
+
+			const ENarrativeConditionResult Result = Reply->EvaluateConditions(OwningPawn, OwningController, NarrativeComponent);
+
+			if (Result == ENarrativeConditionResult::Pending && bOutHasPendingConditions)
+			{
+				*bOutHasPendingConditions = true;
+			}
+
+			if (ResolveConditionResult(Result))
 			{
 				CurrentNode = Reply;
 				break; // just use the first reply with valid conditions
@@ -1,11 +1,104 @@
 // Copyright Narrative Tools 2022. 
 
 #include "Narrative.h"
+#include "Dialogue.h"
+#include "Quest.h"
+#include "DialogueBlueprintGeneratedClass.h"
+#include "QuestBlueprintGeneratedClass.h"
+#include "NarrativeDialogueSequence.h"
+#include "NarrativeDialogueSettings.h"
+#include "LevelSequence.h"
+#include "Serialization/ArchiveCountMem.h"
+#include "UObject/UObjectIterator.h"
 
 DEFINE_LOG_CATEGORY(LogNarrativeRuntime);
 
 #define LOCTEXT_NAMESPACE "FNarrativeModule"
 
+//Add up the memory used by a template and all of its subobjects. Presentation data (shots and the level sequences they use) is tallied separately, as servers strip it 
+static void MeasureTemplateMemory(UObject* Template, int64& OutTotalBytes, int64& OutPresentationBytes)
+{
+	TArray<UObject*> TemplateObjects;
+	GetObjectsWithOuter(Template, TemplateObjects, true);
+	TemplateObjects.Add(Template);
+
+	TSet<UObject*> CountedSequences;
+
+	for (UObject* TemplateObject : TemplateObjects)
+	{
+		FArchiveCountMem CountMem(TemplateObject);
+		const int64 ObjectBytes = CountMem.GetMax();
+
+		OutTotalBytes += ObjectBytes;
+
+		if (UNarrativeDialogueSequence* Shot = Cast<UNarrativeDialogueSequence>(TemplateObject))
+		{
+			OutPresentationBytes += ObjectBytes;
+
+			for (ULevelSequence* SequenceAsset : Shot->GetSequenceAssets())
+			{
+				if (SequenceAsset && !CountedSequences.Contains(SequenceAsset))
+				{
+					CountedSequences.Add(SequenceAsset);
+
+					const int64 SequenceBytes = SequenceAsset->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal);
+					OutTotalBytes += SequenceBytes;
+					OutPresentationBytes += SequenceBytes;
+				}
+			}
+		}
+	}
+}
+
+static void ReportTemplateMemory()
+{
+	const UNarrativeDialogueSettings* DialogueSettings = GetDefault<UNarrativeDialogueSettings>();
+	const bool bStripping = IsRunningDedicatedServer() && DialogueSettings && DialogueSettings->bStripPresentationDataOnServer;
+
+	UE_LOG(LogNarrativeRuntime, Display, TEXT("Narrative template memory (%s, presentation data %s):"), IsRunningDedicatedServer() ? TEXT("dedicated server") : TEXT("client"), bStripping ? TEXT("stripped") : TEXT("loaded"));
+
+	int64 TotalBytes = 0;
+	int64 TotalPresentationBytes = 0;
+
+	for (TObjectIterator<UDialogueBlueprintGeneratedClass> It; It; ++It)
+	{
+		if (UDialogue* DialogueTemplate = It->GetDialogueTemplate())
+		{
+			int64 TemplateBytes = 0;
+			int64 PresentationBytes = 0;
+			MeasureTemplateMemory(DialogueTemplate, TemplateBytes, PresentationBytes);
+
+			UE_LOG(LogNarrativeRuntime, Display, TEXT("  Dialogue %s: %.1f KB, of which presentation %.1f KB"), *It->GetName(), TemplateBytes / 1024.f, PresentationBytes / 1024.f);
+
+			TotalBytes += TemplateBytes;
+			TotalPresentationBytes += PresentationBytes;
+		}
+	}
+
+	for (TObjectIterator<UQuestBlueprintGeneratedClass> It; It; ++It)
+	{
+		if (UQuest* QuestTemplate = It->GetQuestTemplate())
+		{
+			int64 TemplateBytes = 0;
+			int64 PresentationBytes = 0;
+			MeasureTemplateMemory(QuestTemplate, TemplateBytes, PresentationBytes);
+
+			UE_LOG(LogNarrativeRuntime, Display, TEXT("  Quest %s: %.1f KB"), *It->GetName(), TemplateBytes / 1024.f);
+
+			TotalBytes += TemplateBytes;
+			TotalPresentationBytes += PresentationBytes;
+		}
+	}
+
+	UE_LOG(LogNarrativeRuntime, Display, TEXT("Total: %.1f KB, of which presentation %.1f KB. A stripped server would use approx %.1f KB."), TotalBytes / 1024.f, TotalPresentationBytes / 1024.f, (TotalBytes - TotalPresentationBytes) / 1024.f);
+}
+
+static FAutoConsoleCommand ReportTemplateMemoryCommand(
+	TEXT("narrative.ReportTemplateMemory"),
+	TEXT("Log the memory used by each loaded dialogue and quest template, and how much of it is presentation data that dedicated servers strip.\n"),
+	FConsoleCommandDelegate::CreateStatic(&ReportTemplateMemory)
+);
+
 void FNarrativeModule::StartupModule()
 {
 	UE_LOG(LogNarrativeRuntime, Log, TEXT("Narrative Runtime loaded."));
@@ -0,0 +1,174 @@
+// Copyright Narrative Tools 2022. 
+
+
+#include "NarrativeActorRegistry.h"
+#include "Engine/World.h"
+#include "Engine/Level.h"
+#include "GameFramework/Actor.h"
+#include "NarrativeDialoguePool.h"
+#include <EngineUtils.h>
+
+UNarrativeActorRegistry::UNarrativeActorRegistry()
+{
+	bIndexBuilt = false;
+}
+
+bool UNarrativeActorRegistry::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UNarrativeActorRegistry::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	if (UWorld* World = GetWorld())
+	{
+		ActorSpawnedHandle = World->AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateUObject(this, &UNarrativeActorRegistry::OnActorSpawned));
+	}
+
+	LevelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddUObject(this, &UNarrativeActorRegistry::OnLevelAdded);
+}
+
+void UNarrativeActorRegistry::Deinitialize()
+{
+	if (UWorld* World = GetWorld())
+	{
+		World->RemoveOnActorSpawnedHandler(ActorSpawnedHandle);
+	}
+
+	FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedHandle);
+
+	TaggedActors.Empty();
+	MissingTags.Empty();
+	bIndexBuilt = false;
+
+	Super::Deinitialize();
+}
+
+void UNarrativeActorRegistry::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	//Pay for the world sweep while the level loads instead of when the first dialogue opens
+	BuildIndex();
+}
+
+void UNarrativeActorRegistry::BuildIndex()
+{
+	if (bIndexBuilt)
+	{
+		return;
+	}
+
+	bIndexBuilt = true;
+
+	for (FActorIterator It(GetWorld()); It; ++It)
+	{
+		RegisterActor(*It);
+	}
+}
+
+void UNarrativeActorRegistry::OnActorSpawned(AActor* Actor)
+{
+	//No point tracking spawns until the index is built, since building it will pick them up anyway
+	if (bIndexBuilt)
+	{
+		RegisterActor(Actor);
+	}
+}
+
+void UNarrativeActorRegistry::OnLevelAdded(ULevel* Level, UWorld* InWorld)
+{
+	if (bIndexBuilt && Level && InWorld == GetWorld())
+	{
+		for (AActor* Actor : Level->Actors)
+		{
+			RegisterActor(Actor);
+		}
+	}
+}
+
+void UNarrativeActorRegistry::RegisterActor(AActor* Actor)
+{
+	if (!IsValid(Actor))
+	{
+		return;
+	}
+
+	for (const FName& Tag : Actor->Tags)
+	{
+		if (!Tag.IsNone())
+		{
+			TaggedActors.FindOrAdd(Tag).AddUnique(Actor);
+			MissingTags.Remove(Tag);
+		}
+	}
+}
+
+void UNarrativeActorRegistry::UnregisterActor(AActor* Actor)
+{
+	for (auto& TagKVP : TaggedActors)
+	{
+		TagKVP.Value.Remove(Actor);
+	}
+}
+
+void UNarrativeActorRegistry::GetActorsWithTag(const FName& Tag, TArray<AActor*>& OutActors)
+{
+	BuildIndex();
+
+	//Pooled avatars keep their tags while they sit hidden in the pool, but they aren't really in the world so shouldn't be found
+	UWorld* World = GetWorld();
+	const UNarrativeDialoguePool* DialoguePool = World ? World->GetSubsystem<UNarrativeDialoguePool>() : nullptr;
+
+	TArray<TWeakObjectPtr<AActor>>* Actors = TaggedActors.Find(Tag);
+
+	if (Actors)
+	{
+		//Prune destroyed actors and actors that have had the tag removed as we go. Keep the order actors were indexed in, which matches the world iteration order
+		for (int32 i = 0; i < Actors->Num();)
+		{
+			AActor* Actor = (*Actors)[i].Get();
+
+			if (IsValid(Actor) && Actor->ActorHasTag(Tag))
+			{
+				if (!DialoguePool || !DialoguePool->IsAvatarPooled(Actor))
+				{
+					OutActors.Add(Actor);
+				}
+
+				++i;
+			}
+			else
+			{
+				Actors->RemoveAt(i);
+			}
+		}
+	}
+
+	//Tags added after an actor was indexed, ie in BeginPlay or before a deferred spawn finished, won't be in the index. Search the world for them 
+	//once and index whatever we find, but remember tags nothing has so speakers without an avatar in the level don't search the world every time
+	if (World && (!Actors || !Actors->Num()) && !MissingTags.Contains(Tag))
+	{
+		for (TActorIterator<AActor> It(World); It; ++It)
+		{
+			if (It->ActorHasTag(Tag))
+			{
+				RegisterActor(*It);
+
+				if (!DialoguePool || !DialoguePool->IsAvatarPooled(*It))
+				{
+					OutActors.Add(*It);
+				}
+			}
+		}
+
+		const TArray<TWeakObjectPtr<AActor>>* FoundActors = TaggedActors.Find(Tag);
+
+		if (!FoundActors || !FoundActors->Num())
+		{
+			MissingTags.Add(Tag);
+		}
+	}
+}
@@ -0,0 +1,234 @@
+// Copyright Narrative Tools 2022. 
+
+
+#include "NarrativeBarkSubsystem.h"
+#include "Engine/World.h"
+#include "Engine/AssetManager.h"
+#include "GameFramework/Actor.h"
+#include "Components/AudioComponent.h"
+#include "Kismet/GameplayStatics.h"
+#include "Sound/SoundBase.h"
+#include "TimerManager.h"
+#include "Dialogue.h"
+#include "DialogueBlueprintGeneratedClass.h"
+#include "NarrativeComponent.h"
+#include "NarrativeDialogueSettings.h"
+
+bool UNarrativeBarkSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UNarrativeBarkSubsystem::Deinitialize()
+{
+	for (auto& BarkKVP : ActiveBarks)
+	{
+		FNarrativeBark& Bark = BarkKVP.Value;
+
+		if (GetWorld())
+		{
+			GetWorld()->GetTimerManager().ClearTimer(Bark.TimerHandle_BarkFinished);
+		}
+
+		if (Bark.Audio)
+		{
+			Bark.Audio->Stop();
+		}
+
+		if (Bark.SoundHandle.IsValid())
+		{
+			Bark.SoundHandle->CancelHandle();
+		}
+	}
+
+	ActiveBarks.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UNarrativeBarkSubsystem::PlayBark(TSubclassOf<class UDialogue> Dialogue, const FName& NodeID, class AActor* Speaker)
+{
+	UDialogueBlueprintGeneratedClass* DialogueClass = Cast<UDialogueBlueprintGeneratedClass>(Dialogue.Get());
+	UDialogue* DialogueTemplate = DialogueClass ? DialogueClass->GetDialogueTemplate() : nullptr;
+
+	if (!DialogueTemplate)
+	{
+		UE_LOG(LogNarrative, Warning, TEXT("UNarrativeBarkSubsystem::PlayBark was given a dialogue class %s with no dialogue template."), *GetNameSafe(Dialogue.Get()));
+		return false;
+	}
+
+	//Read the line straight out of the template, the dialogue itself is never instanced
+	UDialogueNode* Node = DialogueTemplate->GetNPCReplyByID(NodeID);
+
+	if (!Node)
+	{
+		Node = DialogueTemplate->GetPlayerReplyByID(NodeID);
+	}
+
+	if (!Node)
+	{
+		UE_LOG(LogNarrative, Warning, TEXT("UNarrativeBarkSubsystem::PlayBark couldn't find node %s in dialogue %s."), *NodeID.ToString(), *GetNameSafe(Dialogue.Get()));
+		return false;
+	}
+
+	//Barks are timed like lines on a server, so they never need to wait on audio or sequence events
+	return PlayBarkLine(Node->GetSeededLine(false, FMath::Rand()), Speaker);
+}
+
+bool UNarrativeBarkSubsystem::PlayBarkLine(const FDialogueLine& Line, class AActor* Speaker)
+{
+	UWorld* World = GetWorld();
+
+	//Barks are local only, so there's nobody on a dedicated server to hear them
+	if (!IsValid(Speaker) || !World || World->GetNetMode() == NM_DedicatedServer)
+	{
+		return false;
+	}
+
+	//A speaker only says one thing at a time, so a new bark replaces their old one instead of counting against the budget
+	StopBark(Speaker);
+	RemoveStaleBarks();
+
+	const UNarrativeDialogueSettings* DialogueSettings = GetDefault<UNarrativeDialogueSettings>();
+
+	if (DialogueSettings && ActiveBarks.Num() >= DialogueSettings->MaxConcurrentBarks)
+	{
+		UE_LOG(LogNarrative, Verbose, TEXT("Dropped bark on %s, already playing %d barks."), *GetNameSafe(Speaker), ActiveBarks.Num());
+		return false;
+	}
+
+	FNarrativeBark& Bark = ActiveBarks.Add(Speaker);
+	Bark.Line = Line;
+
+	PlayBarkSound(Speaker, Bark);
+
+	//SetTimer clears the timer if the rate isn't positive, which would leave the bark playing forever
+	const float Duration = FMath::Max(GetBarkDuration(Line), 0.01f);
+	World->GetTimerManager().SetTimer(Bark.TimerHandle_BarkFinished, FTimerDelegate::CreateUObject(this, &UNarrativeBarkSubsystem::BarkFinished, TWeakObjectPtr<AActor>(Speaker)), Duration, false);
+
+	OnBarkStarted.Broadcast(Speaker, Line);
+
+	return true;
+}
+
+void UNarrativeBarkSubsystem::StopBark(class AActor* Speaker)
+{
+	BarkFinished(Speaker);
+}
+
+bool UNarrativeBarkSubsystem::IsBarking(class AActor* Speaker) const
+{
+	return ActiveBarks.Contains(Speaker);
+}
+
+void UNarrativeBarkSubsystem::PlayBarkSound(class AActor* Speaker, FNarrativeBark& Bark)
+{
+	if (!Speaker || Bark.Line.DialogueSound.IsNull())
+	{
+		return;
+	}
+
+	if (USoundBase* Sound = Bark.Line.DialogueSound.Get())
+	{
+		Bark.Audio = UGameplayStatics::SpawnSoundAttached(Sound, Speaker->GetRootComponent(), NAME_None, FVector::ZeroVector, EAttachLocation::KeepRelativeOffset, true);
+	}
+	else
+	{
+		//Loading the sound synchronously would hitch, so start the bark and bring its audio in once the sound has loaded
+		Bark.SoundHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(Bark.Line.DialogueSound.ToSoftObjectPath(),
+			FStreamableDelegate::CreateUObject(this, &UNarrativeBarkSubsystem::OnBarkSoundLoaded, TWeakObjectPtr<AActor>(Speaker)));
+	}
+}
+
+void UNarrativeBarkSubsystem::OnBarkSoundLoaded(TWeakObjectPtr<class AActor> WeakSpeaker)
+{
+	FNarrativeBark* Bark = ActiveBarks.Find(WeakSpeaker);
+	AActor* Speaker = WeakSpeaker.Get();
+
+	if (!Bark || !Speaker || Bark->Audio || !GetWorld())
+	{
+		return;
+	}
+
+	if (USoundBase* Sound = Bark->Line.DialogueSound.Get())
+	{
+		//Skip the audio ahead to wherever the bark is up to, so it stays in time with the subtitle
+		const float Elapsed = FMath::Max(GetWorld()->GetTimerManager().GetTimerElapsed(Bark->TimerHandle_BarkFinished), 0.f);
+
+		Bark->Audio = UGameplayStatics::SpawnSoundAttached(Sound, Speaker->GetRootComponent(), NAME_None, FVector::ZeroVector, EAttachLocation::KeepRelativeOffset, true, 1.f, 1.f, Elapsed);
+	}
+}
+
+void UNarrativeBarkSubsystem::BarkFinished(TWeakObjectPtr<class AActor> WeakSpeaker)
+{
+	FNarrativeBark Bark;
+
+	if (!ActiveBarks.RemoveAndCopyValue(WeakSpeaker, Bark))
+	{
+		return;
+	}
+
+	if (GetWorld())
+	{
+		GetWorld()->GetTimerManager().ClearTimer(Bark.TimerHandle_BarkFinished);
+	}
+
+	if (Bark.Audio)
+	{
+		Bark.Audio->Stop();
+	}
+
+	if (Bark.SoundHandle.IsValid())
+	{
+		Bark.SoundHandle->CancelHandle();
+	}
+
+	OnBarkFinished.Broadcast(WeakSpeaker.Get(), Bark.Line);
+}
+
+float UNarrativeBarkSubsystem::GetBarkDuration(const FDialogueLine& Line) const
+{
+	if (Line.Duration == ELineDuration::LD_AfterDuration)
+	{
+		return Line.DurationSecondsOverride;
+	}
+
+	if (Line.Duration != ELineDuration::LD_AfterReadingTime)
+	{
+		const float SoundDuration = Line.GetSoundDuration();
+
+		if (SoundDuration > 0.f)
+		{
+			return SoundDuration;
+		}
+	}
+
+	float LettersPerSecondLineDuration = 25.f;
+	float MinDialogueTextDisplayTime = 2.f;
+
+	if (const UNarrativeDialogueSettings* DialogueSettings = GetDefault<UNarrativeDialogueSettings>())
+	{
+		LettersPerSecondLineDuration = DialogueSettings->LettersPerSecondLineDuration;
+		MinDialogueTextDisplayTime = DialogueSettings->MinDialogueTextDisplayTime;
+	}
+
+	return FMath::Max(Line.Text.ToString().Len() / LettersPerSecondLineDuration, MinDialogueTextDisplayTime);
+}
+
+void UNarrativeBarkSubsystem::RemoveStaleBarks()
+{
+	TArray<TWeakObjectPtr<AActor>> StaleSpeakers;
+
+	for (auto& BarkKVP : ActiveBarks)
+	{
+		if (!BarkKVP.Key.IsValid())
+		{
+			StaleSpeakers.Add(BarkKVP.Key);
+		}
+	}
+
+	for (auto& StaleSpeaker : StaleSpeakers)
+	{
+		BarkFinished(StaleSpeaker);
+	}
+}
@@ -18,7 +18,12 @@
 #include "NarrativeCondition.h"
 #include "NarrativeEvent.h"
 #include "NarrativeDialogueSettings.h"
+#include "NarrativeQuestSettings.h"
 #include "QuestTask.h"
+#include "Engine/AssetManager.h"
+#include "Engine/GameInstance.h"
+#include "GameFramework/PlayerState.h"
+#include "NarrativeDialogueResumeSubsystem.h"
 
 DEFINE_LOG_CATEGORY(LogNarrative);
 
@@ -52,6 +57,13 @@ UNarrativeComponent::UNarrativeComponent()
 	OnDialogueFinished.AddDynamic(this, &UNarrativeComponent::DialogueFinished);
 
 	bIsLoading = false;
+	NarrativeStateVersion = 0;
+	LastSkipRequestLineIndex = INDEX_NONE;
+	LastSkipRequestTime = -1.f;
+	PreparedDialogue = nullptr;
+	PreparedQuest = nullptr;
+	UpdateSequence = 0;
+	AckedUpdateSequence = 0;
 }
 
 
@@ -61,6 +73,8 @@ void UNarrativeComponent::BeginPlay()
 
 	OwnerPC = GetOwningController();
 
+	UpdateQuestReplicationCondition();
+
 	if (HasAuthority() && GetNetMode() != NM_Standalone && !GetOwner()->bAlwaysRelevant)
 	{
 		UE_LOG(LogNarrative, Warning, TEXT("Narrative has an owning actor %s that is not marked always relevant. This may cause sync issues. "), *GetNameSafe(GetOwner()));
@@ -74,6 +88,27 @@ void UNarrativeComponent::TickComponent(float DeltaTime, enum ELevelTick TickTyp
 	if (CurrentDialogue)
 	{
 		CurrentDialogue->TickDialogue(DeltaTime);
+
+		if (CurrentDialogue && HasAuthority())
+		{
+			CurrentDialogue->UpdateSpeculativeChunks();
+		}
+	}
+
+	if (PendingAsyncBegins.Num())
+	{
+		UpdateAsyncBegins();
+	}
+
+	//Baked here rather than as updates are sent, so the snapshot is never taken halfway through a quest being begun or progressed
+	if (HasAuthority() && PendingUpdateList.Num())
+	{
+		const UNarrativeQuestSettings* QuestSettings = GetDefault<UNarrativeQuestSettings>();
+
+		if (QuestSettings && QuestSettings->MaxReplicatedUpdateHistory > 0 && PendingUpdateList.Num() > QuestSettings->MaxReplicatedUpdateHistory)
+		{
+			BakeQuestSnapshot(GetLastFoldableSequence(FMath::Max(QuestSettings->MaxReplicatedUpdateHistory / 2, 1)));
+		}
 	}
 }
 
@@ -84,20 +119,71 @@ void UNarrativeComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
 
 	if (CurrentDialogue)
 	{
+		//We're going away mid-dialogue, ie the player disconnected or the server is travelling. Keep our place so it can be resumed
+		if (HasAuthority())
+		{
+			if (UNarrativeDialogueResumeSubsystem* ResumeSubsystem = GetResumeSubsystem())
+			{
+				ResumeSubsystem->StoreCursor(ResumeKey, CurrentDialogue->MakeCursor());
+			}
+		}
+
 		CurrentDialogue->Deinitialize();
 	}
 
+	//Nobody is left to begin these for, so stop any loading and throw away anything we'd made
+	for (auto& AsyncBegin : PendingAsyncBegins)
+	{
+		if (AsyncBegin.LoadHandle.IsValid())
+		{
+			AsyncBegin.LoadHandle->CancelHandle();
+		}
+
+		if (UDialogue* Dialogue = Cast<UDialogue>(AsyncBegin.Instance))
+		{
+			Dialogue->Deinitialize();
+		}
+		else if (UQuest* Quest = Cast<UQuest>(AsyncBegin.Instance))
+		{
+			Quest->Deinitialize();
+		}
+	}
+
+	PendingAsyncBegins.Empty();
+
 }
 
 void UNarrativeComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-	DOREPLIFETIME(UNarrativeComponent, PendingUpdateList);
+	const UNarrativeQuestSettings* QuestSettings = GetDefault<UNarrativeQuestSettings>();
+	const ENarrativeQuestReplicationPolicy Policy = QuestSettings ? QuestSettings->QuestReplicationPolicy : ENarrativeQuestReplicationPolicy::OwnerOnly;
+
+	//Party visibility changes as we join and leave parties, so its condition is set at runtime by UpdateQuestReplicationCondition
+	FDoRepLifetimeParams QuestParams;
+	QuestParams.Condition = Policy == ENarrativeQuestReplicationPolicy::Everyone ? COND_None : Policy == ENarrativeQuestReplicationPolicy::Party ? COND_Dynamic : COND_OwnerOnly;
+
+	DOREPLIFETIME_WITH_PARAMS_FAST(UNarrativeComponent, PendingUpdateList, QuestParams);
+	DOREPLIFETIME_WITH_PARAMS_FAST(UNarrativeComponent, QuestSnapshot, QuestParams);
 	DOREPLIFETIME(UNarrativeComponent, PartyComponent);
+}
+
+void UNarrativeComponent::UpdateQuestReplicationCondition()
+{
+	const UNarrativeQuestSettings* QuestSettings = GetDefault<UNarrativeQuestSettings>();
+
+	//Party components override the condition to always replicate, see UNarrativePartyComponent::GetLifetimeReplicatedProps
+	if (!HasAuthority() || IsA<UNarrativePartyComponent>() || !QuestSettings || QuestSettings->QuestReplicationPolicy != ENarrativeQuestReplicationPolicy::Party)
+	{
+		return;
+	}
+
+	//Replication conditions can't pick out individual connections, so while we're in a party our updates go to everyone we're relevant to
+	const ELifetimeCondition Condition = PartyComponent ? COND_None : COND_OwnerOnly;
 
-	//Uncomment if you don't other players narrative components to replicate their updates to you 
-	//DOREPLIFETIME_CONDITION(UNarrativeComponent, PendingUpdateList, COND_OwnerOnly);
+	DOREPDYNAMICCONDITION_SETCONDITION_FAST(UNarrativeComponent, PendingUpdateList, Condition);
+	DOREPDYNAMICCONDITION_SETCONDITION_FAST(UNarrativeComponent, QuestSnapshot, Condition);
 }
 
 bool UNarrativeComponent::HasAuthority() const
@@ -225,6 +311,25 @@ class UQuest* UNarrativeComponent::BeginQuest(TSubclassOf<class UQuest> QuestCla
 	return nullptr;
 }
 
+void UNarrativeComponent::BeginQuestAsync(TSoftClassPtr<class UQuest> QuestClass, FOnQuestBegunAsync OnBegun, FName StartFromID /*= NAME_None*/)
+{
+	if (!HasAuthority() || QuestClass.IsNull())
+	{
+		OnBegun.ExecuteIfBound(nullptr);
+		return;
+	}
+
+	FNarrativeAsyncBegin& AsyncBegin = PendingAsyncBegins.AddDefaulted_GetRef();
+	AsyncBegin.QuestClass = QuestClass;
+	AsyncBegin.StartFromID = StartFromID;
+	AsyncBegin.OnQuestBegun = OnBegun;
+
+	if (QuestClass.IsPending())
+	{
+		AsyncBegin.LoadHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(QuestClass.ToSoftObjectPath());
+	}
+}
+
 bool UNarrativeComponent::RestartQuest(TSubclassOf<class UQuest> QuestClass, FName StartFromID)
 {
 	if (!IsValid(QuestClass))
@@ -283,7 +388,12 @@ bool UNarrativeComponent::HasDialogueAvailable(TSubclassOf<class UDialogue> Dial
 {
 	if (IsValid(DialogueClass))
 	{
-		return MakeDialogueInstance(DialogueClass, StartFromID) != nullptr;
+		if (UDialogue* Dialogue = MakeDialogueInstance(DialogueClass, StartFromID))
+		{
+			//We only wanted to know if the dialogue had anything to say, so let the BeginDialogue that usually follows reuse its nodes
+			Dialogue->ReleaseNodes();
+			return true;
+		}
 	}
 
 	return false;
@@ -302,7 +412,31 @@ bool UNarrativeComponent::SetCurrentDialogue(TSubclassOf<class UDialogue> Dialog
 			CurrentDialogue = nullptr;
 		}
 
-		CurrentDialogue = MakeDialogueInstance(Dialogue, StartFromID);
+		//An async begin may have already made this dialogue on an earlier frame
+		if (PreparedDialogue && PreparedDialogue->GetClass() == Dialogue)
+		{
+			CurrentDialogue = PreparedDialogue;
+		}
+		else
+		{
+			CurrentDialogue = MakeDialogueInstance(Dialogue, StartFromID);
+		}
+
+		PreparedDialogue = nullptr;
+
+		//Line indices start again from zero in the new dialogue
+		LastSkipRequestLineIndex = INDEX_NONE;
+
+		//A player who begins a new dialogue won't want to resume the one they were in before they left 
+		if (HasAuthority() && CurrentDialogue)
+		{
+			ResumeKey = GetResumeKey();
+
+			if (UNarrativeDialogueResumeSubsystem* ResumeSubsystem = GetResumeSubsystem())
+			{
+				ResumeSubsystem->DiscardCursor(ResumeKey);
+			}
+		}
 
 		return CurrentDialogue != nullptr;
 	}
@@ -321,7 +455,7 @@ bool UNarrativeComponent::BeginDialogue(TSubclassOf<class UDialogue> DialogueCla
 
 			if (GetNetMode() != NM_Standalone)
 			{
-				ClientBeginDialogue(DialogueClass, CurrentDialogue->MakeIDsFromNPCNodes(CurrentDialogue->NPCReplyChain), CurrentDialogue->MakeIDsFromPlayerNodes(CurrentDialogue->AvailableResponses));
+				ClientBeginDialogue(DialogueClass, CurrentDialogue->PackCurrentChunk());
 			}
 
 			if (CurrentDialogue)
@@ -334,7 +468,253 @@ bool UNarrativeComponent::BeginDialogue(TSubclassOf<class UDialogue> DialogueCla
 	return false;
 }
 
-void UNarrativeComponent::ClientBeginDialogue_Implementation(TSubclassOf<class UDialogue> DialogueClass, const TArray<FName>& NPCReplyChainIDs, const TArray<FName>& AvailableResponseIDs)
+void UNarrativeComponent::BeginDialogueAsync(TSoftClassPtr<class UDialogue> Dialogue, FOnDialogueBegunAsync OnBegun, FName StartFromID /*= NAME_None*/)
+{
+	if (!HasAuthority() || Dialogue.IsNull())
+	{
+		OnBegun.ExecuteIfBound(nullptr);
+		return;
+	}
+
+	AddAsyncDialogueBegin(Dialogue, OnBegun, StartFromID);
+}
+
+FNarrativeAsyncBegin& UNarrativeComponent::AddAsyncDialogueBegin(TSoftClassPtr<class UDialogue> Dialogue, FOnDialogueBegunAsync OnBegun, FName StartFromID)
+{
+	FNarrativeAsyncBegin& AsyncBegin = PendingAsyncBegins.AddDefaulted_GetRef();
+	AsyncBegin.DialogueClass = Dialogue;
+	AsyncBegin.StartFromID = StartFromID;
+	AsyncBegin.OnDialogueBegun = OnBegun;
+
+	if (Dialogue.IsPending())
+	{
+		AsyncBegin.LoadHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(Dialogue.ToSoftObjectPath());
+	}
+
+	return AsyncBegin;
+}
+
+bool UNarrativeComponent::BeginPreparedDialogue(class UDialogue* Prepared, FName StartFromID)
+{
+	if (!Prepared)
+	{
+		return false;
+	}
+
+	PreparedDialogue = Prepared;
+
+	const bool bBegan = BeginDialogue(Prepared->GetClass(), StartFromID) && CurrentDialogue == Prepared;
+
+	//BeginDialogue can bail before using our instance, in which case it needs cleaning up 
+	if (PreparedDialogue)
+	{
+		PreparedDialogue->Deinitialize();
+		PreparedDialogue = nullptr;
+	}
+
+	return bBegan;
+}
+
+FNarrativeDialogueCursor UNarrativeComponent::GetDialogueCursor() const
+{
+	return CurrentDialogue && HasAuthority() ? CurrentDialogue->MakeCursor() : FNarrativeDialogueCursor();
+}
+
+bool UNarrativeComponent::ResumeDialogue(const FNarrativeDialogueCursor& Cursor, FOnDialogueBegunAsync OnResumed)
+{
+	if (!HasAuthority() || !Cursor.IsValid())
+	{
+		OnResumed.ExecuteIfBound(nullptr);
+		return false;
+	}
+
+	//Generate the chunk the cursor was in from its first node rather than from the root, StepAsyncBegin then skips the lines that already played 
+	FNarrativeAsyncBegin& AsyncBegin = AddAsyncDialogueBegin(Cursor.DialogueClass, OnResumed, Cursor.ChunkStartID);
+	AsyncBegin.ResumeCursor = Cursor;
+
+	return true;
+}
+
+bool UNarrativeComponent::ResumeStoredDialogue()
+{
+	UNarrativeDialogueResumeSubsystem* ResumeSubsystem = GetResumeSubsystem();
+	FNarrativeDialogueCursor Cursor;
+
+	if (HasAuthority() && ResumeSubsystem && ResumeSubsystem->TakeCursor(GetResumeKey(), Cursor))
+	{
+		return ResumeDialogue(Cursor, FOnDialogueBegunAsync());
+	}
+
+	return false;
+}
+
+bool UNarrativeComponent::HasStoredDialogue() const
+{
+	UNarrativeDialogueResumeSubsystem* ResumeSubsystem = GetResumeSubsystem();
+	return ResumeSubsystem && ResumeSubsystem->HasCursor(GetResumeKey());
+}
+
+FString UNarrativeComponent::GetResumeKey() const
+{
+	const APlayerController* OwningController = GetOwningController();
+	const APlayerState* PlayerState = OwningController ? OwningController->PlayerState : nullptr;
+
+	if (!PlayerState)
+	{
+		return FString();
+	}
+
+	//Unique net IDs survive a reconnect, player names are only a fallback for when there's no online subsystem 
+	const FUniqueNetIdRepl& UniqueId = PlayerState->GetUniqueId();
+	return UniqueId.IsValid() ? UniqueId.ToString() : PlayerState->GetPlayerName();
+}
+
+UNarrativeDialogueResumeSubsystem* UNarrativeComponent::GetResumeSubsystem() const
+{
+	const UWorld* World = GetWorld();
+	UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+
+	return GameInstance ? GameInstance->GetSubsystem<UNarrativeDialogueResumeSubsystem>() : nullptr;
+}
+
+void UNarrativeComponent::UpdateAsyncBegins()
+{
+	const UNarrativeDialogueSettings* DialogueSettings = GetDefault<UNarrativeDialogueSettings>();
+	const UNarrativeQuestSettings* QuestSettings = GetDefault<UNarrativeQuestSettings>();
+	const double DialogueBudgetSeconds = (DialogueSettings ? DialogueSettings->AsyncBeginBudgetMs : 2.f) / 1000.0;
+	const double QuestBudgetSeconds = (QuestSettings ? QuestSettings->AsyncBeginBudgetMs : 2.f) / 1000.0;
+	const double StartTime = FPlatformTime::Seconds();
+
+	bool bTookStep = false;
+
+	//Begins are finished in the order they were asked for, so a dialogue that loads quickly can't jump ahead of one asked for earlier
+	while (PendingAsyncBegins.Num())
+	{
+		FNarrativeAsyncBegin& AsyncBegin = PendingAsyncBegins[0];
+
+		const double BudgetSeconds = AsyncBegin.DialogueClass.IsNull() ? QuestBudgetSeconds : DialogueBudgetSeconds;
+
+		if (bTookStep && FPlatformTime::Seconds() - StartTime >= BudgetSeconds)
+		{
+			break;
+		}
+
+		if (AsyncBegin.LoadHandle.IsValid() && !AsyncBegin.LoadHandle->HasLoadCompleted())
+		{
+			break;
+		}
+
+		bTookStep = true;
+
+		//Making an instance and beginning it are both expensive, so once we've made one it waits until next frame to be begun
+		if (!StepAsyncBegin(AsyncBegin))
+		{
+			break;
+		}
+
+		//Take a copy before removing it, since the callback may well ask for another async begin
+		FNarrativeAsyncBegin FinishedBegin = AsyncBegin;
+		PendingAsyncBegins.RemoveAt(0);
+
+		if (FinishedBegin.LoadHandle.IsValid())
+		{
+			FinishedBegin.LoadHandle->ReleaseHandle();
+		}
+
+		if (!FinishedBegin.DialogueClass.IsNull())
+		{
+			FinishedBegin.OnDialogueBegun.ExecuteIfBound(Cast<UDialogue>(FinishedBegin.Instance));
+		}
+		else
+		{
+			FinishedBegin.OnQuestBegun.ExecuteIfBound(Cast<UQuest>(FinishedBegin.Instance));
+		}
+	}
+}
+
+bool UNarrativeComponent::StepAsyncBegin(FNarrativeAsyncBegin& AsyncBegin)
+{
+	if (!AsyncBegin.DialogueClass.IsNull())
+	{
+		TSubclassOf<UDialogue> DialogueClass = AsyncBegin.DialogueClass.Get();
+
+		if (!DialogueClass)
+		{
+			UE_LOG(LogNarrative, Warning, TEXT("BeginDialogueAsync couldn't load dialogue %s."), *AsyncBegin.DialogueClass.ToString());
+			return true;
+		}
+
+		//First step duplicates the template and works out the first chunk, second step actually begins the dialogue
+		if (!AsyncBegin.Instance)
+		{
+			UDialogue* NewDialogue = MakeDialogueInstance(DialogueClass, AsyncBegin.StartFromID);
+
+			if (NewDialogue && AsyncBegin.ResumeCursor.IsValid() && !NewDialogue->RestoreCursor(AsyncBegin.ResumeCursor))
+			{
+				UE_LOG(LogNarrative, Log, TEXT("Couldn't restore the cursor for dialogue %s as its chunk has changed, resuming from the start of node %s instead."), *GetNameSafe(DialogueClass), *AsyncBegin.StartFromID.ToString());
+			}
+
+			AsyncBegin.Instance = NewDialogue;
+			return AsyncBegin.Instance == nullptr;
+		}
+
+		if (!BeginPreparedDialogue(CastChecked<UDialogue>(AsyncBegin.Instance), AsyncBegin.StartFromID))
+		{
+			AsyncBegin.Instance = nullptr;
+		}
+
+		return true;
+	}
+
+	TSubclassOf<UQuest> QuestClass = AsyncBegin.QuestClass.Get();
+
+	if (!QuestClass || QuestClass == UQuest::StaticClass())
+	{
+		UE_LOG(LogNarrative, Warning, TEXT("BeginQuestAsync couldn't load quest %s."), *AsyncBegin.QuestClass.ToString());
+		return true;
+	}
+
+	//First step makes and initializes the quest, second step adds it to our quest list and begins it
+	if (!AsyncBegin.Instance)
+	{
+		if (IsValid(GetQuestInstance(QuestClass)))
+		{
+			UE_LOG(LogNarrative, Warning, TEXT("Narrative was asked to begin a quest the player is already doing. Use RestartQuest() to replay a started quest. "));
+			return true;
+		}
+
+		UQuest* NewQuest = NewObject<UQuest>(GetOwner(), QuestClass);
+
+		if (NewQuest && NewQuest->Initialize(this))
+		{
+			AsyncBegin.Instance = NewQuest;
+			return false;
+		}
+
+		return true;
+	}
+
+	UQuest* PreparedInstance = CastChecked<UQuest>(AsyncBegin.Instance);
+	PreparedQuest = PreparedInstance;
+
+	const bool bBegan = BeginQuest(QuestClass, AsyncBegin.StartFromID) == PreparedInstance;
+
+	//The quest may have been begun some other way since we made ours, in which case ours is thrown away
+	if (PreparedQuest)
+	{
+		PreparedQuest->Deinitialize();
+		PreparedQuest = nullptr;
+	}
+
+	if (!bBegan)
+	{
+		AsyncBegin.Instance = nullptr;
+	}
+
+	return true;
+}
+
+void UNarrativeComponent::ClientBeginDialogue_Implementation(TSubclassOf<class UDialogue> DialogueClass, const FPackedDialogueChunk& Chunk)
 {
 	if (IsValid(DialogueClass))
 	{
@@ -344,7 +724,7 @@ void UNarrativeComponent::ClientBeginDialogue_Implementation(TSubclassOf<class U
 			if (SetCurrentDialogue(DialogueClass))
 			{
 				//Created dialogue won't have a valid chunk yet on the client - use the servers authed chunk it sent
-				ClientRecieveDialogueChunk(NPCReplyChainIDs, AvailableResponseIDs);
+				ClientRecieveDialogueChunk(Chunk);
 
 				OnDialogueBegan.Broadcast(CurrentDialogue);
 			}
@@ -352,12 +732,12 @@ void UNarrativeComponent::ClientBeginDialogue_Implementation(TSubclassOf<class U
 	}
 }
 
-void UNarrativeComponent::BeginPartyDialogue(TSubclassOf<class UDialogue> Dialogue, const TArray<FName>& NPCReplyChainIDs, const TArray<FName>& AvailableResponseIDs)
+void UNarrativeComponent::BeginPartyDialogue(TSubclassOf<class UDialogue> Dialogue, const FPackedDialogueChunk& Chunk)
 {
 	if (HasAuthority() && PartyComponent)
 	{
 		//Tell the client its began a party dialogue, let it construct it 
-		ClientBeginPartyDialogue(Dialogue, NPCReplyChainIDs, AvailableResponseIDs);
+		ClientBeginPartyDialogue(Dialogue, Chunk);
 
 		//By pointing current dialogue at our parties dialogue, the solo dialogue stuff that has already been coded should handle the local dialogue fine! 
 		CurrentDialogue = PartyComponent->CurrentDialogue;
@@ -365,12 +745,12 @@ void UNarrativeComponent::BeginPartyDialogue(TSubclassOf<class UDialogue> Dialog
 
 }
 
-void UNarrativeComponent::ClientBeginPartyDialogue_Implementation(TSubclassOf<class UDialogue> Dialogue, const TArray<FName>& NPCReplyChainIDs, const TArray<FName>& AvailableResponseIDs)
+void UNarrativeComponent::ClientBeginPartyDialogue_Implementation(TSubclassOf<class UDialogue> Dialogue, const FPackedDialogueChunk& Chunk)
 {
 	//Servers began a party dialogue, and now we need to begin ours. 
 	if (PartyComponent)
 	{
-		PartyComponent->ClientBeginDialogue(Dialogue, NPCReplyChainIDs, AvailableResponseIDs);
+		PartyComponent->ClientBeginDialogue(Dialogue, Chunk);
 
 		checkf(PartyComponent->CurrentDialogue,TEXT("We tried starting a dialogue on our party component locally, but it has failed for some reason. "));
 
@@ -401,13 +781,13 @@ void UNarrativeComponent::ClientExitPartyDialogue_Implementation()
 	}
 }
 
-void UNarrativeComponent::ClientRecieveDialogueChunk_Implementation(const TArray<FName>& NPCReplyChainIDs, const TArray<FName>& AvailableResponseIDs)
+void UNarrativeComponent::ClientRecieveDialogueChunk_Implementation(const FPackedDialogueChunk& Chunk)
 {
 	if (!HasAuthority())
 	{
 		if (CurrentDialogue)
 		{
-			CurrentDialogue->ClientReceiveDialogueChunk(NPCReplyChainIDs, AvailableResponseIDs);
+			CurrentDialogue->ClientReceiveDialogueChunk(Chunk);
 		}
 	}
 }
@@ -443,6 +823,26 @@ void UNarrativeComponent::ServerTryExitDialogue_Implementation()
 	TryExitDialogue();
 }
 
+void UNarrativeComponent::AbortDesyncedDialogue()
+{
+	if (!HasAuthority() && CurrentDialogue)
+	{
+		ServerAbortDesyncedDialogue();
+
+		//Don't wait a round trip for the server to tell us to exit, the dialogue is unplayable until then
+		ClientExitDialogue();
+	}
+}
+
+void UNarrativeComponent::ServerAbortDesyncedDialogue_Implementation()
+{
+	if (CurrentDialogue)
+	{
+		UE_LOG(LogNarrative, Warning, TEXT("%s's client couldn't stay in sync with dialogue %s, so it has been exited."), *GetNameSafe(GetOwner()), *GetNameSafe(CurrentDialogue));
+		ExitDialogue();
+	}
+}
+
 bool UNarrativeComponent::IsInDialogue()
 {
 	return CurrentDialogue != nullptr;
@@ -465,7 +865,10 @@ void UNarrativeComponent::TrySelectDialogueOption(class UDialogueNode_Player* Op
 		}
 		else
 		{
-			ServerSelectDialogueOption(Option->GetID());
+			ServerSelectDialogueOption(CurrentDialogue->PackOption(Option));
+
+			//Start playing the option straight away instead of waiting for the server to confirm it
+			CurrentDialogue->PredictSelectDialogueOption(Option);
 		}
 	}
 }
@@ -478,16 +881,24 @@ void UNarrativeComponent::SelectDialogueOption(class UDialogueNode_Player* Optio
 
 		if (bSelectAccepted && GetNetMode() != NM_Standalone)
 		{
-			ClientSelectDialogueOption(Option->GetID(), Selector);
+			ClientSelectDialogueOption(CurrentDialogue->PackOption(Option), Selector);
 		}
 	}
 }
 
-void UNarrativeComponent::ClientSelectDialogueOption_Implementation(const FName& OptionID, class APlayerState* Selector)
+void UNarrativeComponent::ClientSelectDialogueOption_Implementation(const FPackedDialogueOption& PackedOption, class APlayerState* Selector)
 {
 	if (CurrentDialogue)
 	{
-		if (UDialogueNode_Player* Option = CurrentDialogue->GetPlayerReplyByID(OptionID))
+		UDialogueNode_Player* Option = CurrentDialogue->UnpackOption(PackedOption);
+
+		//We already started playing this option when we asked the server to select it 
+		if (Option && CurrentDialogue->ReconcileSelectedOption(Option->GetID()))
+		{
+			return;
+		}
+
+		if (Option)
 		{
 			//We need to aim the camera at the person that actually said the line 
 			if (Selector)
@@ -502,18 +913,18 @@ void UNarrativeComponent::ClientSelectDialogueOption_Implementation(const FName&
 	}
 }
 
-void UNarrativeComponent::ServerSelectDialogueOption_Implementation(const FName& OptionID)
+void UNarrativeComponent::ServerSelectDialogueOption_Implementation(const FPackedDialogueOption& PackedOption)
 {
-	//Resolve the option ID into the actual option object
-	if (CurrentDialogue && !OptionID.IsNone())
+	//Resolve the option index into the actual option object
+	if (CurrentDialogue && PackedOption.OptionIndex != INDEX_NONE)
 	{
-		if (UDialogueNode_Player* OptionNode = CurrentDialogue->GetPlayerReplyByID(OptionID))
+		if (UDialogueNode_Player* OptionNode = CurrentDialogue->UnpackOption(PackedOption))
 		{
 			TrySelectDialogueOption(OptionNode);
 		}
 		else
 		{
-			UE_LOG(LogNarrative, Warning, TEXT("UNarrativeComponent::ServerSelectDialogueOption_Implementation failed to resolve dialogue option %s."), *OptionID.ToString());
+			UE_LOG(LogNarrative, Warning, TEXT("UNarrativeComponent::ServerSelectDialogueOption_Implementation failed to resolve dialogue option %d."), PackedOption.OptionIndex);
 		}
 	}
 }
@@ -531,7 +942,13 @@ bool UNarrativeComponent::TrySkipCurrentDialogueLine()
 		}
 		else
 		{
-			ServerTrySkipCurrentDialogueLine();
+			if (!CanRequestSkip())
+			{
+				return false;
+			}
+
+			LastSkipRequestTime = GetWorld()->GetTimeSeconds();
+			ServerTrySkipCurrentDialogueLine(CurrentDialogue->GetCurrentLineIndex());
 		}
 		return true;
 	}
@@ -552,11 +969,33 @@ bool UNarrativeComponent::SkipCurrentDialogueLine()
 	return false;
 }
 
-void UNarrativeComponent::ServerTrySkipCurrentDialogueLine_Implementation()
+void UNarrativeComponent::ServerTrySkipCurrentDialogueLine_Implementation(const int32 LineIndex)
 {
+	//Collapse repeated requests to skip the same line into one, and ignore clients sending requests much faster than they should be. Only 
+	//hold clients to half the interval they throttle themselves to, otherwise jitter would drop legitimate skips
+	if (LineIndex == LastSkipRequestLineIndex || !CanRequestSkip(0.5f))
+	{
+		return;
+	}
+
+	LastSkipRequestLineIndex = LineIndex;
+	LastSkipRequestTime = GetWorld()->GetTimeSeconds();
+
 	TrySkipCurrentDialogueLine();
 }
 
+bool UNarrativeComponent::CanRequestSkip(const float IntervalScale /*= 1.f*/) const
+{
+	const UNarrativeDialogueSettings* DialogueSettings = GetDefault<UNarrativeDialogueSettings>();
+
+	if (!GetWorld() || !DialogueSettings)
+	{
+		return false;
+	}
+
+	return LastSkipRequestTime < 0.f || GetWorld()->GetTimeSeconds() - LastSkipRequestTime >= DialogueSettings->MinSkipRequestInterval * IntervalScale;
+}
+
 bool UNarrativeComponent::CompleteNarrativeDataTask(const UNarrativeDataTask* Task, const FString& Argument, const int32 Quantity)
 {
 	/**
@@ -593,11 +1032,8 @@ bool UNarrativeComponent::CompleteNarrativeDataTask(const FString& TaskName, con
 			UE_LOG(LogNarrative, Warning, TEXT("Narrative tried finding the asset for Task %s, but couldn't find it."), *TaskName);
 		}
 
-		FString TaskString = (TaskName + '_' + Argument).ToLower();
-		TaskString.RemoveSpacesInline();
-
 		//Convert the Task into an FString and run it through our active quests state machines
-		return CompleteNarrativeTask_Internal(TaskString, false, Quantity);
+		return CompleteNarrativeTask_Internal(MakeTaskString(TaskName, Argument), false, Quantity);
 	}
 	else
 	{
@@ -620,6 +1056,16 @@ class UQuest* UNarrativeComponent::MakeQuestInstance(TSubclassOf<class UQuest> Q
 			return nullptr;
 		}
 
+		//An async begin may have already made and initialized this quest on an earlier frame
+		if (PreparedQuest && PreparedQuest->GetClass() == QuestClass)
+		{
+			UQuest* NewQuest = PreparedQuest;
+			PreparedQuest = nullptr;
+
+			QuestList.Add(NewQuest);
+			return NewQuest;
+		}
+
 		if (UQuest* NewQuest = NewObject<UQuest>(GetOwner(), QuestClass))
 		{
 			const bool bInitializedSuccessfully = NewQuest->Initialize(this);
@@ -647,12 +1093,39 @@ bool UNarrativeComponent::CompleteNarrativeTask_Internal(const FString& RawTaskS
 			MasterTaskList.Add(RawTaskString, Quantity);
 		}
 
+		NarrativeStateChanged();
+
 		//In Narrative 3 CompleteNarrativeTask is no longer used for updating quests and is more of a legacy feature, so no more to do
 		return true;
 	}
 	return false;
 }
 
+FString UNarrativeComponent::MakeTaskString(const FString& TaskName, const FString& Argument)
+{
+	FString TaskString = (TaskName + '_' + Argument).ToLower();
+	TaskString.RemoveSpacesInline();
+	return TaskString;
+}
+
+void UNarrativeComponent::AdjustTaskCountSilently(const FString& TaskName, const FString& Argument, const int32 Quantity)
+{
+	const FString TaskString = MakeTaskString(TaskName, Argument);
+	int32& TimesCompleted = MasterTaskList.FindOrAdd(TaskString);
+
+	TimesCompleted += Quantity;
+
+	if (TimesCompleted <= 0)
+	{
+		MasterTaskList.Remove(TaskString);
+	}
+}
+
+void UNarrativeComponent::NarrativeStateChanged()
+{
+	++NarrativeStateVersion;
+}
+
 class UDialogue* UNarrativeComponent::MakeDialogueInstance(TSubclassOf<class UDialogue> DialogueClass, FName StartFromID /*= NAME_None*/)
 {
 	if (IsValid(DialogueClass))
@@ -669,6 +1142,9 @@ class UDialogue* UNarrativeComponent::MakeDialogueInstance(TSubclassOf<class UDi
 			{
 				return NewDialogue;
 			}
+
+			//A dialogue with nothing to say can still hand its nodes on to the next one
+			NewDialogue->ReleaseNodes();
 		}
 	}
 	return nullptr;
@@ -705,12 +1181,115 @@ void UNarrativeComponent::SendNarrativeUpdate(const FNarrativeUpdate& Update)
 		PendingUpdateList.Add(Update);
 		ensure(PendingUpdateList.Num());
 		PendingUpdateList.Last().CreationTime = GetWorld()->GetTimeSeconds();
+		PendingUpdateList.Last().Sequence = ++UpdateSequence;
+	}
+
+	//Stale updates aren't removed from the list here, as clients that hadn't processed them yet would lose sync. Instead TickComponent 
+	//folds the updates every client has got past into a quest snapshot once it grows past MaxReplicatedUpdateHistory, see BakeQuestSnapshot
+}
+
+uint32 UNarrativeComponent::GetLastFoldableSequence(const int32 NumUpdatesToKeep) const
+{
+	if (PendingUpdateList.Num() <= NumUpdatesToKeep)
+	{
+		return 0;
+	}
+
+	//Keep the newest updates for anyone else our updates are replicated to, since only our owner can tell us how far it has got
+	uint32 LastFoldable = PendingUpdateList[PendingUpdateList.Num() - NumUpdatesToKeep - 1].Sequence;
+
+	//A remote owner that hasn't processed an update yet would have to load the snapshot instead, restarting all of its quests
+	const AActor* Owner = GetOwner();
+
+	if (Owner && Owner->GetNetConnection())
+	{
+		LastFoldable = FMath::Min(LastFoldable, AckedUpdateSequence);
+	}
+
+	//Updates sent this frame haven't been replicated to anyone yet, ie a Load() or a quest cascade that sent a burst of them
+	const float Now = GetWorld() ? GetWorld()->GetTimeSeconds() : 0.f;
+
+	for (const FNarrativeUpdate& Update : PendingUpdateList)
+	{
+		if (Update.CreationTime >= Now)
+		{
+			LastFoldable = FMath::Min(LastFoldable, Update.Sequence - 1);
+			break;
+		}
+	}
+
+	return LastFoldable;
+}
+
+void UNarrativeComponent::ServerAckUpdateSequence_Implementation(const uint32 Sequence)
+{
+	//Acks can arrive out of order, and a client can't have processed updates we haven't sent
+	AckedUpdateSequence = FMath::Clamp(Sequence, AckedUpdateSequence, UpdateSequence);
+}
+
+void UNarrativeComponent::BakeQuestSnapshot(const uint32 LastFoldedSequence)
+{
+	int32 NumToFold = 0;
+
+	while (NumToFold < PendingUpdateList.Num() && PendingUpdateList[NumToFold].Sequence <= LastFoldedSequence)
+	{
+		++NumToFold;
+	}
+
+	if (NumToFold <= 0)
+	{
+		return;
 	}
 
-	//STALE UPDATE REMOVAL: Disabled as was causing sync issues 
-	//Remove stale updates from the pendingupdatelist, otherwise it might grow to be huge
-	//TODO could the update list history around be used to add more functionality? Its essentially a history of everything the player has done in order, could be valuable
+	MakeSavedQuests(QuestSnapshot.Quests);
+
+	//TMaps arent networked so send the MasterTaskList as two arrays
+	MasterTaskList.GenerateKeyArray(QuestSnapshot.Tasks);
+	MasterTaskList.GenerateValueArray(QuestSnapshot.Quantities);
+
+	QuestSnapshot.LastSequence = PendingUpdateList[NumToFold - 1].Sequence;
+	QuestSnapshot.StateSequence = UpdateSequence;
+
+	PendingUpdateList.RemoveAt(0, NumToFold);
+}
+
+void UNarrativeComponent::MakeSavedQuests(TArray<FNarrativeSavedQuest>& OutSavedQuests) const
+{
+	OutSavedQuests.Empty(QuestList.Num());
+
+	for (auto& Quest : QuestList)
+	{
+		if (Quest)
+		{
+			FNarrativeSavedQuest Save;
+			Save.QuestClass = Quest->GetClass();
+			Save.CurrentStateID = Quest->GetCurrentState() ? Quest->GetCurrentState()->GetID() : NAME_None;
+
+			//Save all the quests branches, and the current progress on each branches task 
+			for (UQuestBranch* Branch : Quest->Branches)
+			{
+				TArray<int32> TasksProgress;
+
+				for (auto& BranchTask : Branch->QuestTasks)
+				{
+					if (BranchTask)
+					{
+						TasksProgress.Add(BranchTask->CurrentProgress);
+					}
+				}
+
+				Save.QuestBranches.Add(FSavedQuestBranch(Branch->GetID(), TasksProgress));
+			}
+
+			//Store all the reached states in the save file
+			for (UQuestState* State : Quest->ReachedStates)
+			{
+				Save.ReachedStateNames.Add(State->GetID());
+			}
 
+			OutSavedQuests.Add(Save);
+		}
+	}
 }
 
 void UNarrativeComponent::OnRep_PartyComponent(class UNarrativePartyComponent* OldPartyComponent)
@@ -723,88 +1302,137 @@ void UNarrativeComponent::OnRep_PartyComponent(class UNarrativePartyComponent* O
 	{
 		OnLeaveParty.Broadcast(OldPartyComponent);
 	}
+
+	UpdateQuestReplicationCondition();
 }
 
 void UNarrativeComponent::OnRep_PendingUpdateList()
+{
+	ApplyReplicatedUpdates();
+}
+
+void UNarrativeComponent::OnRep_QuestSnapshot()
+{
+	ApplyReplicatedUpdates();
+}
+
+void UNarrativeComponent::ApplyReplicatedUpdates()
 {
 	//Process any updates the server has ran in the same order to ensure sync without having to replace a whole array of uquests 
 	if (GetOwnerRole() < ROLE_Authority)
 	{
-		for (auto& Update : PendingUpdateList)
+		const uint32 SequenceBefore = UpdateSequence;
+
+		//We're missing updates that have since been folded into the snapshot, ie because we joined late. Load it in instead of replaying them.
+		//The server only folds updates the owner has acked, so this is only for clients with no quest state yet, or non owners that fell behind
+		//the updates the server keeps for them, since loading forgets and restarts every quest
+		if (QuestSnapshot.LastSequence > UpdateSequence)
 		{
-			if (!Update.bAcked)
+			ensure(QuestSnapshot.Tasks.Num() == QuestSnapshot.Quantities.Num());
+
+			TMap<FString, int32> RemadeTaskList;
+			for (int32 Idx = 0; Idx < QuestSnapshot.Tasks.Num() && Idx < QuestSnapshot.Quantities.Num(); ++Idx)
 			{
-				switch (Update.UpdateType)
-				{
-					case EUpdateType::UT_None:
-					{
-						//UE_LOG(LogTemp, Warning, TEXT("Client recieved a UT_None update from server with payload %s. Please submit a bug report explaining how this happened. "), *Update.Payload);
-					}
-					break;
-					case EUpdateType::UT_CompleteTask:
-					{
-						if (Update.IntPayload.IsValidIndex(0))
-						{
-							CompleteNarrativeTask_Internal(Update.Payload, true, Update.IntPayload[0]);
-						}
-					}
-					break;
-					case EUpdateType::UT_TaskProgressMade:
-					{
-						if (Update.IntPayload.IsValidIndex(0) && Update.IntPayload.IsValidIndex(1))
-						{
-							const uint8 TaskIndex = Update.IntPayload[0];
-							const uint8 NewProgress = Update.IntPayload[1];
+				RemadeTaskList.Add(QuestSnapshot.Tasks[Idx], QuestSnapshot.Quantities[Idx]);
+			}
 
-							if (UQuest* Quest = GetQuestInstance(Update.QuestClass))
-							{
-								FName BranchID = FName(Update.Payload);
+			Load_Internal(QuestSnapshot.Quests, RemadeTaskList);
 
-								if (UQuestBranch* Branch = Quest->GetBranch(BranchID))
-								{
-									if (Branch->QuestTasks.IsValidIndex(TaskIndex))
-									{
-										Branch->QuestTasks[TaskIndex]->SetProgressInternal(NewProgress, true);
-									}
-								}
-							}
-						}
-					}
-					break;
-					case EUpdateType::UT_BeginQuest:
-					{
-						BeginQuest(Update.QuestClass, FName(Update.Payload));
-					}
-					break;
-					case EUpdateType::UT_RestartQuest:
-					{
-						RestartQuest(Update.QuestClass, FName(Update.Payload));
-					}
-					break;
-					case EUpdateType::UT_ForgetQuest:
-					{
-						ForgetQuest(Update.QuestClass);
-					}
-					break;
-					case EUpdateType::UT_QuestNewState:
+			//The snapshot already includes the updates that were kept in the list, so don't replay them on top of it
+			UpdateSequence = QuestSnapshot.StateSequence;
+		}
+
+		for (const FNarrativeUpdate& Update : PendingUpdateList)
+		{
+			//Already processed this one
+			if (Update.Sequence <= UpdateSequence)
+			{
+				continue;
+			}
+
+			//There's a gap between the last update we processed and this one, meaning the server baked a new snapshot that hasn't reached us yet. 
+			//Replaying this update without the ones before it would put us out of sync, so wait for the snapshot
+			if (Update.Sequence != UpdateSequence + 1)
+			{
+				break;
+			}
+
+			ProcessNarrativeUpdate(Update);
+			UpdateSequence = Update.Sequence;
+		}
+
+		if (UpdateSequence != SequenceBefore && GetOwnerRole() == ROLE_AutonomousProxy)
+		{
+			ServerAckUpdateSequence(UpdateSequence);
+		}
+	}
+}
+
+void UNarrativeComponent::ProcessNarrativeUpdate(const FNarrativeUpdate& Update)
+{
+	switch (Update.UpdateType)
+	{
+		case EUpdateType::UT_None:
+		{
+			//UE_LOG(LogTemp, Warning, TEXT("Client recieved a UT_None update from server with payload %s. Please submit a bug report explaining how this happened. "), *Update.Payload);
+		}
+		break;
+		case EUpdateType::UT_CompleteTask:
+		{
+			if (Update.IntPayload.IsValidIndex(0))
+			{
+				CompleteNarrativeTask_Internal(Update.Payload, true, Update.IntPayload[0]);
+			}
+		}
+		break;
+		case EUpdateType::UT_TaskProgressMade:
+		{
+			if (Update.IntPayload.IsValidIndex(0) && Update.IntPayload.IsValidIndex(1))
+			{
+				const uint8 TaskIndex = Update.IntPayload[0];
+				const uint8 NewProgress = Update.IntPayload[1];
+
+				if (UQuest* Quest = GetQuestInstance(Update.QuestClass))
+				{
+					FName BranchID = FName(Update.Payload);
+
+					if (UQuestBranch* Branch = Quest->GetBranch(BranchID))
 					{
-						if (UQuest* Quest = GetQuestInstance(Update.QuestClass))
+						if (Branch->QuestTasks.IsValidIndex(TaskIndex))
 						{
-							//Server should always have a valid state to tell us to go to
-							check(!Update.Payload.IsEmpty());
-
-							Quest->EnterState_Internal(Quest->GetState(FName(Update.Payload)));
+							Branch->QuestTasks[TaskIndex]->SetProgressInternal(NewProgress, true);
 						}
 					}
-					break;
 				}
-
-				Update.bAcked = true;
 			}
 		}
+		break;
+		case EUpdateType::UT_BeginQuest:
+		{
+			BeginQuest(Update.QuestClass, FName(Update.Payload));
+		}
+		break;
+		case EUpdateType::UT_RestartQuest:
+		{
+			RestartQuest(Update.QuestClass, FName(Update.Payload));
+		}
+		break;
+		case EUpdateType::UT_ForgetQuest:
+		{
+			ForgetQuest(Update.QuestClass);
+		}
+		break;
+		case EUpdateType::UT_QuestNewState:
+		{
+			if (UQuest* Quest = GetQuestInstance(Update.QuestClass))
+			{
+				//Server should always have a valid state to tell us to go to
+				check(!Update.Payload.IsEmpty());
 
-		//Clear the inputs out once we've processed them 
-		//PendingUpdateList.Empty();
+				Quest->EnterState_Internal(Quest->GetState(FName(Update.Payload)));
+			}
+		}
+		break;
 	}
 }
 
@@ -885,6 +1513,8 @@ void UNarrativeComponent::NarrativeDataTaskCompleted(const UNarrativeDataTask* N
 
 void UNarrativeComponent::QuestStarted(const UQuest* Quest)
 {
+	NarrativeStateChanged();
+
 	if (Quest)
 	{
 		UE_LOG(LogNarrative, Log, TEXT("Quest started: %s"), *GetNameSafe(Quest));
@@ -893,6 +1523,8 @@ void UNarrativeComponent::QuestStarted(const UQuest* Quest)
 
 void UNarrativeComponent::QuestForgotten(const UQuest* Quest)
 {
+	NarrativeStateChanged();
+
 	if (Quest)
 	{
 		UE_LOG(LogNarrative, Log, TEXT("Quest forgotten: %s"), *GetNameSafe(Quest));
@@ -901,6 +1533,8 @@ void UNarrativeComponent::QuestForgotten(const UQuest* Quest)
 
 void UNarrativeComponent::QuestFailed(const UQuest* Quest, const FText& QuestFailedMessage)
 {
+	NarrativeStateChanged();
+
 	if (Quest)
 	{
 		UE_LOG(LogNarrative, Log, TEXT("Quest failed: %s. Failure state: %s"), *GetNameSafe(Quest), *QuestFailedMessage.ToString());
@@ -909,6 +1543,8 @@ void UNarrativeComponent::QuestFailed(const UQuest* Quest, const FText& QuestFai
 
 void UNarrativeComponent::QuestSucceeded(const UQuest* Quest, const FText& QuestSucceededMessage)
 {
+	NarrativeStateChanged();
+
 	// No need to autosave on quest succeeded because QuestObjectiveCompleted already performs an autosave and is called on quest completion
 	if (Quest)
 	{
@@ -918,6 +1554,8 @@ void UNarrativeComponent::QuestSucceeded(const UQuest* Quest, const FText& Quest
 
 void UNarrativeComponent::QuestNewState(UQuest* Quest, const UQuestState* NewState)
 {
+	NarrativeStateChanged();
+
 	// No need to autosave on new objective because QuestObjectiveCompleted already performs an autosave and is called when we get a new objective
 	if (Quest)
 	{
@@ -937,6 +1575,8 @@ void UNarrativeComponent::QuestNewState(UQuest* Quest, const UQuestState* NewSta
 
 void UNarrativeComponent::QuestTaskProgressMade(const UQuest* Quest, const UNarrativeTask* Task, const class UQuestBranch* Branch, int32 OldProgress, int32 NewProgress)
 {
+	NarrativeStateChanged();
+
 	if (Quest && Task)
 	{
 		UE_LOG(LogNarrative, Log, TEXT("Quest %s made progress - task %s is now %d/%d"), *GetNameSafe(Quest), *(Task->GetTaskDescription().ToString()), NewProgress, Task->RequiredQuantity);
@@ -1140,39 +1780,7 @@ bool UNarrativeComponent::Save(const FString& SaveName/** = "NarrativeSaveData"*
 	{
 		NarrativeSaveGame->MasterTaskList = MasterTaskList;
 
-		for (auto& Quest : QuestList)
-		{
-			if (Quest)
-			{
-				FNarrativeSavedQuest Save;
-				Save.QuestClass = Quest->GetClass();
-				Save.CurrentStateID = Quest->GetCurrentState()->GetID();
-
-				//Save all the quests branches, and the current progress on each branches task 
-				for (UQuestBranch* Branch : Quest->Branches)
-				{
-					TArray<int32> TasksProgress;
-
-					for (auto& BranchTask : Branch->QuestTasks)
-					{
-						if (BranchTask)
-						{
-							TasksProgress.Add(BranchTask->CurrentProgress);
-						}
-					}
-
-					Save.QuestBranches.Add(FSavedQuestBranch(Branch->GetID(), TasksProgress));
-				}
-
-				//Store all the reached states in the save file
-				for (UQuestState* State : Quest->ReachedStates)
-				{
-					Save.ReachedStateNames.Add(State->GetID());
-				}
-
-				NarrativeSaveGame->SavedQuests.Add(Save);
-			}
-		}
+		MakeSavedQuests(NarrativeSaveGame->SavedQuests);
 
 		if (UGameplayStatics::SaveGameToSlot(NarrativeSaveGame, SaveName, Slot))
 		{
@@ -1253,6 +1861,7 @@ void UNarrativeComponent::ClientReceiveSave_Implementation(const TArray<FNarrati
 bool UNarrativeComponent::Load_Internal(const TArray<FNarrativeSavedQuest>& SavedQuests, const TMap<FString, int32>& NewMasterList)
 {
 	bIsLoading = true;
+	NarrativeStateChanged();
 
 	//Remove all our current quests - we're about the load the new ones from the save file 
 	for (int32 i = QuestList.Num() - 1; i >= 0; --i)
@@ -9,6 +9,76 @@ bool UNarrativeCondition::CheckCondition_Implementation(APawn* Pawn, APlayerCont
 	return true;
 }
 
+void UNarrativeCondition::BeginLatentCheck_Implementation(APawn* Pawn, APlayerController* Controller, class UNarrativeComponent* NarrativeComponent)
+{
+	FinishLatentCheck(NarrativeComponent, CheckCondition(Pawn, Controller, NarrativeComponent));
+}
+
+void UNarrativeCondition::FinishLatentCheck(class UNarrativeComponent* NarrativeComponent, const bool bPassed)
+{
+	check(IsInGameThread());
+
+	//Check was reset while it was in flight, so this result is stale
+	if (!PendingLatentChecks.Remove(NarrativeComponent))
+	{
+		return;
+	}
+
+	LatentResults.Add(NarrativeComponent, bPassed);
+}
+
+ENarrativeConditionResult UNarrativeCondition::EvaluateCondition(APawn* Pawn, APlayerController* Controller, class UNarrativeComponent* NarrativeComponent)
+{
+	bool bPassed = false;
+
+	if (bIsLatent)
+	{
+		if (const bool* LatentResult = LatentResults.Find(NarrativeComponent))
+		{
+			bPassed = *LatentResult;
+		}
+		else
+		{
+			if (!PendingLatentChecks.Contains(NarrativeComponent))
+			{
+				PendingLatentChecks.Add(NarrativeComponent);
+				BeginLatentCheck(Pawn, Controller, NarrativeComponent);
+
+				//The check may have finished synchronously 
+				if (const bool* SyncResult = LatentResults.Find(NarrativeComponent))
+				{
+					return *SyncResult != bNot ? ENarrativeConditionResult::Passed : ENarrativeConditionResult::Failed;
+				}
+			}
+
+			return ENarrativeConditionResult::Pending;
+		}
+	}
+	else
+	{
+		bPassed = CheckCondition(Pawn, Controller, NarrativeComponent);
+	}
+
+	return bPassed != bNot ? ENarrativeConditionResult::Passed : ENarrativeConditionResult::Failed;
+}
+
+bool UNarrativeCondition::EvaluateConditionThreadSafe(APawn* Pawn, APlayerController* Controller, class UNarrativeComponent* NarrativeComponent)
+{
+	return CheckCondition_Implementation(Pawn, Controller, NarrativeComponent) != bNot;
+}
+
+void UNarrativeCondition::ResetLatentCheck()
+{
+	LatentResults.Empty();
+	PendingLatentChecks.Empty();
+}
+
+bool UNarrativeCondition::IsThreadSafe() const
+{
+	//Blueprint subclasses may override CheckCondition, which would have to run through ProcessEvent on the game thread
+	return bThreadSafe && !bIsLatent && GetClass()->HasAnyClassFlags(CLASS_Native) && !GetClass()->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(UNarrativeCondition, CheckCondition));
+}
+
 FString UNarrativeCondition::GetGraphDisplayText_Implementation()
 {
 	return GetName();
@@ -0,0 +1,257 @@
+// Copyright Narrative Tools 2022. 
+
+
+#include "NarrativeDialogueCache.h"
+#include "Engine/World.h"
+#include "Dialogue.h"
+#include "DialogueSM.h"
+#include "DialogueBlueprintGeneratedClass.h"
+#include "NarrativeComponent.h"
+#include "NarrativeDialogueSettings.h"
+#include "Serialization/ArchiveCountMem.h"
+#include "UObject/UObjectIterator.h"
+
+static void ReportDialogueCache()
+{
+	for (TObjectIterator<UNarrativeDialogueCache> It; It; ++It)
+	{
+		if (!It->HasAnyFlags(RF_ClassDefaultObject))
+		{
+			It->LogReport();
+		}
+	}
+}
+
+static FAutoConsoleCommand ReportDialogueCacheCommand(
+	TEXT("narrative.ReportDialogueCache"),
+	TEXT("Log the hit rate and memory use of each worlds dialogue cache.\n"),
+	FConsoleCommandDelegate::CreateStatic(&ReportDialogueCache)
+);
+
+//Copy every property blueprints can write to from the template node, since the last dialogue may have changed any of them
+static void ResetNodeFromTemplate(UDialogueNode* Node, const UDialogueNode* TemplateNode)
+{
+	if (Node->GetClass() != TemplateNode->GetClass())
+	{
+		return;
+	}
+
+	for (TFieldIterator<FProperty> It(Node->GetClass()); It; ++It)
+	{
+		FProperty* Property = *It;
+
+		if (!Property->HasAnyPropertyFlags(CPF_BlueprintVisible) || Property->HasAnyPropertyFlags(CPF_BlueprintReadOnly))
+		{
+			continue;
+		}
+
+		//Instanced objects belong to the node, copying them would leave us pointing at the templates. The line is handled below
+		if (Property->HasAnyPropertyFlags(CPF_InstancedReference | CPF_ContainsInstancedReference))
+		{
+			continue;
+		}
+
+		Property->CopyCompleteValue_InContainer(Node, TemplateNode);
+	}
+
+	UNarrativeDialogueSequence* Shot = Node->Line.Shot;
+	Node->Line = TemplateNode->Line;
+	Node->Line.Shot = Shot;
+}
+
+template<typename NodeType>
+static void ResetNodesFromTemplate(const TArray<NodeType*>& Nodes, const TArray<NodeType*>& TemplateNodes)
+{
+	TMap<FName, NodeType*> TemplateNodesByID;
+
+	for (NodeType* TemplateNode : TemplateNodes)
+	{
+		if (TemplateNode && !TemplateNode->GetID().IsNone())
+		{
+			TemplateNodesByID.Add(TemplateNode->GetID(), TemplateNode);
+		}
+	}
+
+	for (int32 i = 0; i < Nodes.Num(); ++i)
+	{
+		if (!Nodes[i])
+		{
+			continue;
+		}
+
+		//Nodes are duplicates of the template so they're in the same order, which is all we have to go on if a node doesn't have an ID
+		NodeType* const* TemplateNode = Nodes[i]->GetID().IsNone() ? nullptr : TemplateNodesByID.Find(Nodes[i]->GetID());
+		NodeType* FallbackNode = !TemplateNode && TemplateNodes.IsValidIndex(i) ? TemplateNodes[i] : nullptr;
+
+		if (const UDialogueNode* SourceNode = TemplateNode ? *TemplateNode : FallbackNode)
+		{
+			ResetNodeFromTemplate(Nodes[i], SourceNode);
+		}
+	}
+}
+
+UNarrativeDialogueCache::UNarrativeDialogueCache()
+{
+	CachedBytes = 0;
+	Hits = 0;
+	Misses = 0;
+}
+
+bool UNarrativeDialogueCache::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UNarrativeDialogueCache::Deinitialize()
+{
+	EmptyCache();
+
+	Super::Deinitialize();
+}
+
+UDialogue* UNarrativeDialogueCache::AcquireNodes(TSubclassOf<class UDialogue> DialogueClass, class UDialogue* NewOwner)
+{
+	if (!DialogueClass || !NewOwner)
+	{
+		return nullptr;
+	}
+
+	//Search from the back, so the most recently used nodes get reused and the older ones are left to be evicted
+	for (int32 i = Entries.Num() - 1; i >= 0; --i)
+	{
+		if (Entries[i].DialogueClass == DialogueClass && IsValid(Entries[i].Nodes))
+		{
+			UDialogue* Nodes = Entries[i].Nodes;
+
+			CachedBytes -= Entries[i].Bytes;
+			Entries.RemoveAt(i);
+
+			//Conditions and events find their world through their outers, so the nodes need to live inside the dialogue using them
+			Nodes->Rename(*MakeUniqueObjectName(NewOwner, Nodes->GetClass()).ToString(), NewOwner, REN_DontCreateRedirectors | REN_NonTransactional | REN_DoNotDirty);
+
+			++Hits;
+			return Nodes;
+		}
+	}
+
+	++Misses;
+	return nullptr;
+}
+
+void UNarrativeDialogueCache::ReleaseNodes(TSubclassOf<class UDialogue> DialogueClass, class UDialogue* Nodes)
+{
+	const UNarrativeDialogueSettings* DialogueSettings = GetDefault<UNarrativeDialogueSettings>();
+
+	if (!DialogueClass || !IsValid(Nodes) || !DialogueSettings || DialogueSettings->MaxCachedDialogues <= 0)
+	{
+		return;
+	}
+
+	ResetNodes(DialogueClass, Nodes);
+
+	//Take the nodes off the dialogue that used them, so it can be garbage collected while they sit in the cache
+	Nodes->Rename(*MakeUniqueObjectName(this, Nodes->GetClass()).ToString(), this, REN_DontCreateRedirectors | REN_NonTransactional | REN_DoNotDirty);
+
+	FCachedDialogueNodes& Entry = Entries.AddDefaulted_GetRef();
+	Entry.DialogueClass = DialogueClass;
+	Entry.Nodes = Nodes;
+	Entry.Bytes = MeasureNodes(Nodes);
+
+	CachedBytes += Entry.Bytes;
+
+	EvictToLimits();
+}
+
+bool UNarrativeDialogueCache::HasCachedNodes(TSubclassOf<class UDialogue> DialogueClass) const
+{
+	return Entries.ContainsByPredicate([DialogueClass](const FCachedDialogueNodes& Entry)
+	{
+		return Entry.DialogueClass == DialogueClass && IsValid(Entry.Nodes);
+	});
+}
+
+void UNarrativeDialogueCache::EmptyCache()
+{
+	Entries.Empty();
+	CachedBytes = 0;
+}
+
+float UNarrativeDialogueCache::GetHitRate() const
+{
+	const int32 Total = Hits + Misses;
+	return Total > 0 ? (float)Hits / Total : 0.f;
+}
+
+void UNarrativeDialogueCache::LogReport() const
+{
+	UE_LOG(LogNarrative, Display, TEXT("Dialogue cache for %s: %d hits, %d misses (%.1f%% hit rate), %d cached dialogues using %.1f KB."),
+		*GetNameSafe(GetWorld()), Hits, Misses, GetHitRate() * 100.f, Entries.Num(), CachedBytes / 1024.f);
+}
+
+void UNarrativeDialogueCache::ResetNodes(TSubclassOf<class UDialogue> DialogueClass, class UDialogue* Nodes)
+{
+	UDialogueBlueprintGeneratedClass* BGClass = Cast<UDialogueBlueprintGeneratedClass>(DialogueClass.Get());
+
+	if (UDialogue* DialogueTemplate = BGClass ? BGClass->GetDialogueTemplate() : nullptr)
+	{
+		ResetNodesFromTemplate(Nodes->NPCReplies, DialogueTemplate->NPCReplies);
+		ResetNodesFromTemplate(Nodes->PlayerReplies, DialogueTemplate->PlayerReplies);
+	}
+
+	TArray<UDialogueNode*> AllNodes;
+	AllNodes.Append(Nodes->NPCReplies);
+	AllNodes.Append(Nodes->PlayerReplies);
+
+	for (UDialogueNode* Node : AllNodes)
+	{
+		if (Node)
+		{
+			Node->OwningDialogue = nullptr;
+			Node->OwningComponent = nullptr;
+			Node->PlayedLine = FDialogueLine();
+			Node->OnDialogueFinished.Clear();
+
+			//Latent results are kept per narrative component, so the same player beginning the dialogue again would otherwise reuse an old result,
+			//or wait forever on a check that was still running when the last dialogue ended
+			Node->ResetLatentConditions();
+		}
+	}
+}
+
+int64 UNarrativeDialogueCache::MeasureNodes(class UDialogue* Nodes)
+{
+	if (const int64* KnownBytes = BytesPerClass.Find(Nodes->GetClass()))
+	{
+		return *KnownBytes;
+	}
+
+	TArray<UObject*> NodeObjects;
+	GetObjectsWithOuter(Nodes, NodeObjects, true);
+	NodeObjects.Add(Nodes);
+
+	int64 Bytes = 0;
+
+	for (UObject* NodeObject : NodeObjects)
+	{
+		FArchiveCountMem CountMem(NodeObject);
+		Bytes += CountMem.GetMax();
+	}
+
+	BytesPerClass.Add(Nodes->GetClass(), Bytes);
+
+	return Bytes;
+}
+
+void UNarrativeDialogueCache::EvictToLimits()
+{
+	const UNarrativeDialogueSettings* DialogueSettings = GetDefault<UNarrativeDialogueSettings>();
+
+	const int32 MaxEntries = DialogueSettings ? DialogueSettings->MaxCachedDialogues : 0;
+	const int64 MaxBytes = DialogueSettings ? (int64)DialogueSettings->MaxDialogueCacheMemoryKB * 1024 : 0;
+
+	while (Entries.Num() && (Entries.Num() > MaxEntries || CachedBytes > MaxBytes))
+	{
+		CachedBytes -= Entries[0].Bytes;
+		Entries.RemoveAt(0);
+	}
+}
@@ -0,0 +1,293 @@
+// Copyright Narrative Tools 2022. 
+
+
+#include "NarrativeDialoguePool.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Animation/AnimInstance.h"
+#include "NarrativeDialogueSettings.h"
+#include "LevelSequenceActor.h"
+#include "LevelSequencePlayer.h"
+
+static int32 GetMaxPooledAvatars()
+{
+	const UNarrativeDialogueSettings* DialogueSettings = GetDefault<UNarrativeDialogueSettings>();
+	return DialogueSettings && DialogueSettings->bPoolSpeakerAvatars ? DialogueSettings->MaxPooledAvatarsPerClass : 0;
+}
+
+static int32 GetMaxPooledSequenceActors()
+{
+	const UNarrativeDialogueSettings* DialogueSettings = GetDefault<UNarrativeDialogueSettings>();
+	return DialogueSettings ? DialogueSettings->MaxPooledSequenceActors : 0;
+}
+
+bool UNarrativeDialoguePool::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UNarrativeDialoguePool::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	//Dedicated servers never see speaker avatars so don't bother prewarming them 
+	if (InWorld.GetNetMode() == NM_DedicatedServer)
+	{
+		return;
+	}
+
+	if (const UNarrativeDialogueSettings* DialogueSettings = GetDefault<UNarrativeDialogueSettings>())
+	{
+		for (auto& PrewarmKVP : DialogueSettings->PrewarmedSpeakerAvatars)
+		{
+			if (UClass* AvatarClass = PrewarmKVP.Key.LoadSynchronous())
+			{
+				PrewarmAvatars(AvatarClass, PrewarmKVP.Value);
+			}
+		}
+
+		PrewarmSequenceActors(DialogueSettings->PrewarmedSequenceActors);
+	}
+}
+
+void UNarrativeDialoguePool::Deinitialize()
+{
+	for (auto& PoolKVP : AvatarPool)
+	{
+		for (AActor* Avatar : PoolKVP.Value.FreeAvatars)
+		{
+			if (IsValid(Avatar))
+			{
+				Avatar->Destroy();
+			}
+		}
+	}
+
+	AvatarPool.Empty();
+
+	for (ALevelSequenceActor* SequenceActor : FreeSequenceActors)
+	{
+		if (IsValid(SequenceActor))
+		{
+			SequenceActor->Destroy();
+		}
+	}
+
+	FreeSequenceActors.Empty();
+
+	Super::Deinitialize();
+}
+
+AActor* UNarrativeDialoguePool::AcquireAvatar(TSubclassOf<class AActor> AvatarClass, const FTransform& Transform, class AActor* Owner)
+{
+	if (!IsValid(AvatarClass))
+	{
+		return nullptr;
+	}
+
+	if (FNarrativeAvatarPoolEntry* PoolEntry = AvatarPool.Find(AvatarClass))
+	{
+		while (PoolEntry->FreeAvatars.Num())
+		{
+			AActor* Avatar = PoolEntry->FreeAvatars.Pop(false);
+
+			//Something else may have destroyed the avatar while it was pooled
+			if (IsValid(Avatar))
+			{
+				//Put collision and ticking back how the avatars class has them, rather than forcing them on for avatars that start without them
+				const AActor* AvatarCDO = Avatar->GetClass()->GetDefaultObject<AActor>();
+
+				Avatar->SetOwner(Owner);
+				Avatar->SetActorTransform(Transform, false, nullptr, ETeleportType::ResetPhysics);
+				Avatar->SetActorHiddenInGame(false);
+				Avatar->SetActorEnableCollision(AvatarCDO->GetActorEnableCollision());
+				Avatar->SetActorTickEnabled(AvatarCDO->PrimaryActorTick.bStartWithTickEnabled);
+				return Avatar;
+			}
+		}
+	}
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.bNoFail = true;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	SpawnParams.Owner = Owner;
+
+	if (UWorld* World = GetWorld())
+	{
+		return World->SpawnActor(AvatarClass, &Transform, SpawnParams);
+	}
+
+	return nullptr;
+}
+
+void UNarrativeDialoguePool::ReleaseAvatar(class AActor* Avatar)
+{
+	if (!IsValid(Avatar) || IsAvatarPooled(Avatar))
+	{
+		return;
+	}
+
+	const int32 MaxPoolSize = GetMaxPooledAvatars();
+
+	FNarrativeAvatarPoolEntry& PoolEntry = AvatarPool.FindOrAdd(Avatar->GetClass());
+
+	if (PoolEntry.FreeAvatars.Num() >= MaxPoolSize)
+	{
+		Avatar->Destroy();
+		return;
+	}
+
+	ResetAvatar(Avatar);
+	PoolEntry.FreeAvatars.Add(Avatar);
+}
+
+void UNarrativeDialoguePool::PrewarmAvatars(TSubclassOf<class AActor> AvatarClass, const int32 Count)
+{
+	//Don't prewarm more avatars than the pool would hold onto, or any at all if pooling is turned off
+	const int32 NumToPrewarm = FMath::Min(Count, GetMaxPooledAvatars());
+
+	if (!IsValid(AvatarClass) || !GetWorld() || NumToPrewarm <= 0)
+	{
+		return;
+	}
+
+	FNarrativeAvatarPoolEntry& PoolEntry = AvatarPool.FindOrAdd(AvatarClass);
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.bNoFail = true;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	while (PoolEntry.FreeAvatars.Num() < NumToPrewarm)
+	{
+		if (AActor* Avatar = GetWorld()->SpawnActor(AvatarClass, &FTransform::Identity, SpawnParams))
+		{
+			ResetAvatar(Avatar);
+			PoolEntry.FreeAvatars.Add(Avatar);
+		}
+		else
+		{
+			break;
+		}
+	}
+}
+
+bool UNarrativeDialoguePool::IsAvatarPooled(class AActor* Avatar) const
+{
+	if (Avatar)
+	{
+		if (const FNarrativeAvatarPoolEntry* PoolEntry = AvatarPool.Find(Avatar->GetClass()))
+		{
+			return PoolEntry->FreeAvatars.Contains(Avatar);
+		}
+	}
+
+	return false;
+}
+
+void UNarrativeDialoguePool::ResetAvatar(class AActor* Avatar)
+{
+	Avatar->SetOwner(nullptr);
+	Avatar->SetActorHiddenInGame(true);
+	Avatar->SetActorEnableCollision(false);
+	Avatar->SetActorTickEnabled(false);
+
+	//Stop any dialogue anims that were still blending out so the avatar comes out of the pool in its idle pose
+	TArray<USkeletalMeshComponent*> Meshes;
+	Avatar->GetComponents<USkeletalMeshComponent>(Meshes);
+
+	for (USkeletalMeshComponent* Mesh : Meshes)
+	{
+		if (UAnimInstance* AnimInstance = Mesh ? Mesh->GetAnimInstance() : nullptr)
+		{
+			AnimInstance->StopAllMontages(0.f);
+		}
+	}
+}
+
+ALevelSequenceActor* UNarrativeDialoguePool::SpawnSequenceActor()
+{
+	if (UWorld* World = GetWorld())
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.ObjectFlags |= RF_Transient;
+		SpawnParams.bAllowDuringConstructionScript = true;
+
+		return World->SpawnActor<ALevelSequenceActor>(SpawnParams);
+	}
+
+	return nullptr;
+}
+
+ALevelSequenceActor* UNarrativeDialoguePool::AcquireSequenceActor(const FMovieSceneSequencePlaybackSettings& PlaybackSettings)
+{
+	ALevelSequenceActor* SequenceActor = nullptr;
+
+	while (!SequenceActor && FreeSequenceActors.Num())
+	{
+		SequenceActor = FreeSequenceActors.Pop(false);
+
+		if (!IsValid(SequenceActor) || !SequenceActor->SequencePlayer)
+		{
+			SequenceActor = nullptr;
+		}
+	}
+
+	if (!SequenceActor)
+	{
+		SequenceActor = SpawnSequenceActor();
+	}
+
+	if (SequenceActor && SequenceActor->SequencePlayer)
+	{
+		SequenceActor->PlaybackSettings = PlaybackSettings;
+		SequenceActor->SequencePlayer->SetPlaybackSettings(PlaybackSettings);
+	}
+
+	return SequenceActor;
+}
+
+void UNarrativeDialoguePool::ReleaseSequenceActor(class ALevelSequenceActor* SequenceActor)
+{
+	if (!IsValid(SequenceActor) || FreeSequenceActors.Contains(SequenceActor))
+	{
+		return;
+	}
+
+	const int32 MaxPoolSize = GetMaxPooledSequenceActors();
+
+	if (SequenceActor->SequencePlayer)
+	{
+		SequenceActor->SequencePlayer->Stop();
+		SequenceActor->SequencePlayer->OnFinished.Clear();
+	}
+
+	if (FreeSequenceActors.Num() >= MaxPoolSize)
+	{
+		SequenceActor->Destroy();
+		return;
+	}
+
+	//Clear out whatever shot was last played so the next dialogue starts from a clean player 
+	SequenceActor->SetSequence(nullptr);
+	SequenceActor->bOverrideInstanceData = false;
+	FreeSequenceActors.Add(SequenceActor);
+}
+
+void UNarrativeDialoguePool::PrewarmSequenceActors(const int32 Count)
+{
+	//Don't prewarm more sequence actors than the pool would hold onto
+	const int32 NumToPrewarm = FMath::Min(Count, GetMaxPooledSequenceActors());
+
+	while (FreeSequenceActors.Num() < NumToPrewarm)
+	{
+		if (ALevelSequenceActor* SequenceActor = SpawnSequenceActor())
+		{
+			FreeSequenceActors.Add(SequenceActor);
+		}
+		else
+		{
+			break;
+		}
+	}
+}
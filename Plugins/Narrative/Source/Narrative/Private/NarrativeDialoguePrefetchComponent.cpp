@@ -0,0 +1,217 @@
+// Copyright Narrative Tools 2022. 
+
+
+#include "NarrativeDialoguePrefetchComponent.h"
+#include "Engine/World.h"
+#include "Engine/AssetManager.h"
+#include "GameFramework/Actor.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "Dialogue.h"
+#include "DialogueSM.h"
+#include "DialogueBlueprintGeneratedClass.h"
+#include "NarrativeDialogueCache.h"
+
+UNarrativeDialoguePrefetchComponent::UNarrativeDialoguePrefetchComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+
+	//Players don't cover much ground in half a second, so there's no need to check every frame
+	PrimaryComponentTick.TickInterval = 0.5f;
+
+	PrefetchRadius = 2000.f;
+	ReleaseTimeout = 30.f;
+	bPrefetchFirstLineMedia = true;
+	LastInRangeTime = 0.f;
+}
+
+void UNarrativeDialoguePrefetchComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	if (!GetWorld())
+	{
+		return;
+	}
+
+	if (IsPlayerInRange())
+	{
+		LastInRangeTime = GetWorld()->GetTimeSeconds();
+
+		if (!DialogueHandle.IsValid())
+		{
+			Prefetch();
+		}
+	}
+	else if (DialogueHandle.IsValid() && GetWorld()->GetTimeSeconds() - LastInRangeTime > ReleaseTimeout)
+	{
+		ReleasePrefetch();
+	}
+}
+
+void UNarrativeDialoguePrefetchComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	ReleasePrefetch();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+bool UNarrativeDialoguePrefetchComponent::IsPlayerInRange() const
+{
+	const AActor* Owner = GetOwner();
+
+	if (!Owner)
+	{
+		return false;
+	}
+
+	const FVector Location = Owner->GetActorLocation();
+	const float RadiusSquared = FMath::Square(PrefetchRadius);
+
+	//Clients only know about their own player controllers, servers know about everyones, so each loads what its own players might need
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		if (const APlayerController* PC = It->Get())
+		{
+			if (const APawn* Pawn = PC->GetPawn())
+			{
+				if (FVector::DistSquared(Pawn->GetActorLocation(), Location) <= RadiusSquared)
+				{
+					return true;
+				}
+			}
+		}
+	}
+
+	return false;
+}
+
+void UNarrativeDialoguePrefetchComponent::Prefetch()
+{
+	if (DialogueHandle.IsValid() || !UAssetManager::IsValid())
+	{
+		return;
+	}
+
+	//Prefetch can be called manually with no player around, so give it the full timeout before TickComponent lets go of it again
+	if (GetWorld())
+	{
+		LastInRangeTime = GetWorld()->GetTimeSeconds();
+	}
+
+	TArray<FSoftObjectPath> DialoguePaths;
+
+	for (auto& Dialogue : Dialogues)
+	{
+		if (!Dialogue.IsNull())
+		{
+			DialoguePaths.Add(Dialogue.ToSoftObjectPath());
+		}
+	}
+
+	if (!DialoguePaths.Num())
+	{
+		return;
+	}
+
+	DialogueHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(DialoguePaths, FStreamableDelegate::CreateUObject(this, &UNarrativeDialoguePrefetchComponent::OnDialoguesLoaded));
+}
+
+void UNarrativeDialoguePrefetchComponent::ReleasePrefetch()
+{
+	//Cancel rather than release, in case the dialogues are still loading and would otherwise call OnDialoguesLoaded after we've let go of them
+	if (DialogueHandle.IsValid())
+	{
+		DialogueHandle->CancelHandle();
+		DialogueHandle.Reset();
+	}
+
+	if (MediaHandle.IsValid())
+	{
+		MediaHandle->ReleaseHandle();
+		MediaHandle.Reset();
+	}
+
+	PreparedDialogues.Empty();
+}
+
+bool UNarrativeDialoguePrefetchComponent::IsPrefetched() const
+{
+	if (!DialogueHandle.IsValid() || !DialogueHandle->HasLoadCompleted())
+	{
+		return false;
+	}
+
+	//Dialogues that failed to load or aren't dialogue blueprints never make it into PreparedDialogues, so we're only done if every one did
+	int32 NumDialogues = 0;
+
+	for (auto& Dialogue : Dialogues)
+	{
+		if (!Dialogue.IsNull())
+		{
+			++NumDialogues;
+		}
+	}
+
+	return NumDialogues > 0 && PreparedDialogues.Num() == NumDialogues;
+}
+
+TSubclassOf<class UDialogue> UNarrativeDialoguePrefetchComponent::GetPrefetchedDialogue(const int32 Index) const
+{
+	return Dialogues.IsValidIndex(Index) ? Dialogues[Index].Get() : nullptr;
+}
+
+void UNarrativeDialoguePrefetchComponent::OnDialoguesLoaded()
+{
+	PreparedDialogues.Empty();
+
+	TArray<FSoftObjectPath> MediaPaths;
+
+	UNarrativeDialogueCache* DialogueCache = GetWorld() ? GetWorld()->GetSubsystem<UNarrativeDialogueCache>() : nullptr;
+
+	for (auto& Dialogue : Dialogues)
+	{
+		UDialogueBlueprintGeneratedClass* DialogueClass = Cast<UDialogueBlueprintGeneratedClass>(Dialogue.Get());
+		UDialogue* DialogueTemplate = DialogueClass ? DialogueClass->GetDialogueTemplate() : nullptr;
+
+		if (!DialogueTemplate)
+		{
+			continue;
+		}
+
+		PreparedDialogues.Add(DialogueClass);
+
+		//Dialogues compiled before node checksums existed work theirs out when instanced, so do it now instead
+		if (!DialogueTemplate->GetNodeTableChecksum())
+		{
+			DialogueTemplate->BakeNodeTableChecksum();
+		}
+
+		//Duplicating the template is the slow part of beginning a dialogue, so do it now and leave the nodes in the cache for BeginDialogue to pick up
+		if (DialogueCache && !DialogueCache->HasCachedNodes(DialogueClass))
+		{
+			if (UDialogue* Nodes = Cast<UDialogue>(StaticDuplicateObject(DialogueTemplate, DialogueCache, NAME_None, RF_Transactional)))
+			{
+				Nodes->SetFlags(RF_Transient | RF_DuplicateTransient);
+				DialogueCache->ReleaseNodes(DialogueClass, Nodes);
+			}
+		}
+
+		//The first line plays as soon as the dialogue begins, so there's no time to stream its media in then
+		if (bPrefetchFirstLineMedia && DialogueTemplate->RootDialogue)
+		{
+			DialogueTemplate->RootDialogue->Line.GetMediaPaths(MediaPaths);
+
+			for (auto& AltLine : DialogueTemplate->RootDialogue->AlternativeLines)
+			{
+				AltLine.GetMediaPaths(MediaPaths);
+			}
+		}
+	}
+
+	//Dedicated servers never play dialogue media
+	if (MediaPaths.Num() && GetWorld() && GetWorld()->GetNetMode() != NM_DedicatedServer && !MediaHandle.IsValid())
+	{
+		MediaHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(MediaPaths, FStreamableDelegate());
+	}
+}
@@ -0,0 +1,68 @@
+// Copyright Narrative Tools 2022. 
+
+
+#include "NarrativeDialogueResumeSubsystem.h"
+#include "NarrativeDialogueSettings.h"
+
+static double GetDialogueResumeTimeout()
+{
+	const UNarrativeDialogueSettings* DialogueSettings = GetDefault<UNarrativeDialogueSettings>();
+	return DialogueSettings ? DialogueSettings->DialogueResumeTimeout : 120.0;
+}
+
+void UNarrativeDialogueResumeSubsystem::RemoveExpiredCursors()
+{
+	const double Now = FPlatformTime::Seconds();
+	const double Timeout = GetDialogueResumeTimeout();
+
+	for (auto It = StoredCursors.CreateIterator(); It; ++It)
+	{
+		if (Now - It->Value.StoredTime > Timeout)
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+void UNarrativeDialogueResumeSubsystem::StoreCursor(const FString& PlayerKey, const FNarrativeDialogueCursor& Cursor)
+{
+	if (PlayerKey.IsEmpty() || !Cursor.IsValid())
+	{
+		return;
+	}
+
+	RemoveExpiredCursors();
+
+	FStoredDialogueCursor& StoredCursor = StoredCursors.FindOrAdd(PlayerKey);
+	StoredCursor.Cursor = Cursor;
+	StoredCursor.StoredTime = FPlatformTime::Seconds();
+}
+
+bool UNarrativeDialogueResumeSubsystem::TakeCursor(const FString& PlayerKey, FNarrativeDialogueCursor& OutCursor)
+{
+	FStoredDialogueCursor StoredCursor;
+
+	if (!StoredCursors.RemoveAndCopyValue(PlayerKey, StoredCursor))
+	{
+		return false;
+	}
+
+	if (FPlatformTime::Seconds() - StoredCursor.StoredTime > GetDialogueResumeTimeout())
+	{
+		return false;
+	}
+
+	OutCursor = StoredCursor.Cursor;
+	return true;
+}
+
+void UNarrativeDialogueResumeSubsystem::DiscardCursor(const FString& PlayerKey)
+{
+	StoredCursors.Remove(PlayerKey);
+}
+
+bool UNarrativeDialogueResumeSubsystem::HasCursor(const FString& PlayerKey) const
+{
+	const FStoredDialogueCursor* StoredCursor = StoredCursors.Find(PlayerKey);
+	return StoredCursor && FPlatformTime::Seconds() - StoredCursor->StoredTime <= GetDialogueResumeTimeout();
+}
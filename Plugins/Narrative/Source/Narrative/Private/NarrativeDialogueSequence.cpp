@@ -7,6 +7,7 @@
 #include <DefaultLevelSequenceInstanceData.h>
 #include <CineCameraComponent.h>
 #include "Dialogue.h"
+#include "NarrativeDialogueSettings.h"
 #include <Engine/TargetPoint.h>
 
 static const FName NAME_AnchorTag("Anchor");
@@ -37,6 +38,18 @@ UNarrativeDialogueSequence::UNarrativeDialogueSequence()
 	PlaybackSettings.bDisableCameraCuts = false;
 }
 
+bool UNarrativeDialogueSequence::NeedsLoadForServer() const
+{
+	const UNarrativeDialogueSettings* DialogueSettings = GetDefault<UNarrativeDialogueSettings>();
+
+	if (DialogueSettings && DialogueSettings->bStripPresentationDataOnServer)
+	{
+		return false;
+	}
+
+	return Super::NeedsLoadForServer();
+}
+
 void UNarrativeDialogueSequence::Tick(const float DeltaTime)
 {
 	//Update the relative offset every frame if setting is enabled  
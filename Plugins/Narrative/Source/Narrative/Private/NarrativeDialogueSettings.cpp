@@ -8,6 +8,23 @@ UNarrativeDialogueSettings::UNarrativeDialogueSettings()
 	MinDialogueTextDisplayTime = 2.f;
 	DialogueLineAudioSilence = 0.5f;
 	bAutoSelectSingleResponse = false;
+	bPendingConditionsPass = false;
+	PendingConditionTimeout = 1.f;
+	ParallelConditionReplyThreshold = 16;
+	bPoolSpeakerAvatars = true;
+	MaxPooledAvatarsPerClass = 4;
+	PrewarmedSequenceActors = 1;
+	MaxPooledSequenceActors = 2;
+	MaxCachedDialogues = 8;
+	MaxDialogueCacheMemoryKB = 4096;
+	DialogueMediaPrefetchLines = 8;
+	bStripPresentationDataOnServer = true;
+	bPredictDialogueOnClients = true;
+	SpeculativeChunkBudgetMs = 0.5f;
+	MinSkipRequestInterval = 0.1f;
+	DialogueResumeTimeout = 120.f;
+	MaxConcurrentBarks = 8;
+	AsyncBeginBudgetMs = 2.f;
 	bEnableVerticalWiring = true;
 
 	SpeakerColors.Add(FLinearColor(0.036161, 0.115986, 0.265625, 1.000000));
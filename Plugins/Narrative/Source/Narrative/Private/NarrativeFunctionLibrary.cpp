@@ -82,3 +82,18 @@ FString UNarrativeFunctionLibrary::MakeDisplayString(const FString& String)
 {
 	return FName::NameToDisplayString(String, false);
 }
+
+class USoundBase* UNarrativeFunctionLibrary::GetDialogueLineSound(const FDialogueLine& Line)
+{
+	return Line.GetDialogueSound();
+}
+
+class UAnimMontage* UNarrativeFunctionLibrary::GetDialogueLineMontage(const FDialogueLine& Line)
+{
+	return Line.GetDialogueMontage();
+}
+
+class UAnimMontage* UNarrativeFunctionLibrary::GetDialogueLineFacialAnimation(const FDialogueLine& Line)
+{
+	return Line.GetFacialAnimation();
+}
@@ -6,11 +6,13 @@
 #include "NarrativeEvent.h"
 #include "NarrativeComponent.h"
 #include "NarrativePartyComponent.h"
+#include "NarrativeDialogueSettings.h"
 
 UNarrativeNodeBase::UNarrativeNodeBase()
 {
 	//autofill the ID
 	ID = GetFName();
+	UpdateStableIDHash();
 }
 
 #if WITH_EDITOR
@@ -25,64 +27,149 @@ void UNarrativeNodeBase::PostEditChangeProperty(FPropertyChangedEvent& PropertyC
 		if (PropertyChangedEvent.MemberProperty->GetFName() == GET_MEMBER_NAME_CHECKED(UNarrativeNodeBase, ID))
 		{
 			EnsureUniqueID();
+			UpdateStableIDHash();
+		}
+		else if (PropertyChangedEvent.MemberProperty->GetFName() == GET_MEMBER_NAME_CHECKED(UNarrativeNodeBase, Events))
+		{
+			PartitionEvents();
 		}
 	}
 }
 
 #endif 
 
+void UNarrativeNodeBase::PostLoad()
+{
+	Super::PostLoad();
+
+	UpdateStableIDHash();
+
+	//Nodes compiled before events were partitioned won't have their start/end lists yet 
+	if (!bEventsPartitioned)
+	{
+		PartitionEvents();
+	}
+}
+
+void UNarrativeNodeBase::UpdateStableIDHash()
+{
+	//FNames are case insensitive, and can have different casing in different processes 
+	StableIDHash = FCrc::StrCrc32(*ID.ToString().ToLower());
+}
+
+void UNarrativeNodeBase::PartitionEvents()
+{
+	StartEvents.Reset();
+	EndEvents.Reset();
+
+	for (auto& Event : Events)
+	{
+		if (Event)
+		{
+			if (Event->EventRuntime == EEventRuntime::Start || Event->EventRuntime == EEventRuntime::Both)
+			{
+				StartEvents.Add(Event);
+			}
+
+			if (Event->EventRuntime == EEventRuntime::End || Event->EventRuntime == EEventRuntime::Both)
+			{
+				EndEvents.Add(Event);
+			}
+		}
+	}
+
+	bEventsPartitioned = true;
+}
+
 void UNarrativeNodeBase::ProcessEvents(APawn* Pawn, APlayerController* Controller, class UNarrativeComponent* NarrativeComponent, const EEventRuntime Runtime)
 {
+	TArray<UNarrativeEvent*> BothEvents;
+
+	//Runtime is only ever Both if someone calls this from BP asking for events marked as Both, so just filter those out manually
+	if (Runtime == EEventRuntime::Both)
+	{
+		for (auto& Event : Events)
+		{
+			if (Event && Event->EventRuntime == EEventRuntime::Both)
+			{
+				BothEvents.Add(Event);
+			}
+		}
+	}
+
+	const TArray<UNarrativeEvent*>& EventsToRun = Runtime == EEventRuntime::Start ? StartEvents : Runtime == EEventRuntime::End ? EndEvents : BothEvents;
+
+	//Most nodes don't have any events for this runtime, so bail out before doing any work
+	if (EventsToRun.Num() == 0)
+	{
+		return;
+	}
+
 	if (!NarrativeComponent)
 	{
 		UE_LOG(LogNarrative, Warning, TEXT("Tried running events on node %s but Narrative Comp was null."), *GetNameSafe(this));
 		return;
 	}
 
-	for (auto& Event : Events)
+	//Resolve the party members once up front instead of for every event 
+	UNarrativePartyComponent* PartyComp = Cast<UNarrativePartyComponent>(NarrativeComponent);
+	const TArray<UNarrativeComponent*> PartyMembers = PartyComp ? PartyComp->GetPartyMembers() : TArray<UNarrativeComponent*>();
+	UNarrativeComponent* PartyLeader = PartyComp ? PartyComp->GetPartyLeader() : nullptr;
+
+	for (auto& Event : EventsToRun)
 	{
-		if (Event && (Event->EventRuntime == Runtime || Event->EventRuntime == EEventRuntime::Both))
+		if (!Event)
 		{
-			TArray<UNarrativeComponent*> CompsToExecute;
+			continue;
+		}
 
-			if (UNarrativePartyComponent* PartyComp = Cast<UNarrativePartyComponent>(NarrativeComponent))
+		if (PartyComp)
+		{
+			if (Event->PartyEventPolicy == EPartyEventPolicy::AllPartyMembers)
 			{
-				if (Event->PartyEventPolicy == EPartyEventPolicy::AllPartyMembers)
+				for (auto& PartyMember : PartyMembers)
 				{
-					CompsToExecute.Append(PartyComp->GetPartyMembers());
-				}
-				else if (Event->PartyEventPolicy == EPartyEventPolicy::PartyLeader)
-				{
-					CompsToExecute.Add(PartyComp->GetPartyLeader());
-				}
-				else if (Event->PartyEventPolicy == EPartyEventPolicy::Party)
-				{
-					CompsToExecute.Add(PartyComp);
+					if (PartyMember)
+					{
+						Event->ExecuteEvent(PartyMember->GetOwningPawn(), PartyMember->GetOwningController(), PartyMember);
+					}
 				}
 			}
-			else
+			else if (Event->PartyEventPolicy == EPartyEventPolicy::PartyLeader)
 			{
-				CompsToExecute.Add(NarrativeComponent);
+				if (PartyLeader)
+				{
+					Event->ExecuteEvent(PartyLeader->GetOwningPawn(), PartyLeader->GetOwningController(), PartyLeader);
+				}
 			}
-
-			for (auto& Comp : CompsToExecute)
+			else if (Event->PartyEventPolicy == EPartyEventPolicy::Party)
 			{
-				Event->ExecuteEvent(Comp->GetOwningPawn(), Comp->GetOwningController(), Comp);
+				Event->ExecuteEvent(PartyComp->GetOwningPawn(), PartyComp->GetOwningController(), PartyComp);
 			}
-
+		}
+		else
+		{
+			Event->ExecuteEvent(NarrativeComponent->GetOwningPawn(), NarrativeComponent->GetOwningController(), NarrativeComponent);
 		}
 	}
 }
 
 bool UNarrativeNodeBase::AreConditionsMet(APawn* Pawn, APlayerController* Controller, class UNarrativeComponent* NarrativeComponent)
+{
+	return ResolveConditionResult(EvaluateConditions(Pawn, Controller, NarrativeComponent));
+}
+
+ENarrativeConditionResult UNarrativeNodeBase::EvaluateConditions(APawn* Pawn, APlayerController* Controller, class UNarrativeComponent* NarrativeComponent)
 {
 
 	if (!NarrativeComponent)
 	{
 		UE_LOG(LogNarrative, Warning, TEXT("Tried running conditions on node %s but Narrative Comp was null."), *GetNameSafe(this));
-		return false;
+		return ENarrativeConditionResult::Failed;
 	}
-	  
+	
+	bool bAnyPending = false;
+
 	//Ensure all conditions are met
 	for (auto& Cond : Conditions)
 	{	
@@ -109,14 +196,15 @@ bool UNarrativeNodeBase::AreConditionsMet(APawn* Pawn, APlayerController* Contro
 				}
 
 				bool bAnyonePassed = false;
+				bool bAnyonePending = false;
 
 				//If any of our comps to check fail, return false 
 				for (auto& ComponentToCheck : ComponentsToCheck)
 				{	
-					const bool bConditionPassed = Cond && Cond->CheckCondition(ComponentToCheck->GetOwningPawn(), ComponentToCheck->GetOwningController(), ComponentToCheck) != Cond->bNot;
-					FString CondString = bConditionPassed ? "passed" : "failed";
+					const ENarrativeConditionResult Result = Cond->EvaluateCondition(ComponentToCheck->GetOwningPawn(), ComponentToCheck->GetOwningController(), ComponentToCheck);
+					FString CondString = Result == ENarrativeConditionResult::Passed ? "passed" : Result == ENarrativeConditionResult::Pending ? "pending" : "failed";
 
-					if (bConditionPassed)
+					if (Result == ENarrativeConditionResult::Passed)
 					{
 						//We'll check the next condition since someone passed
 						if (Cond->PartyConditionPolicy == EPartyConditionPolicy::AnyPlayerPasses)
@@ -125,34 +213,100 @@ bool UNarrativeNodeBase::AreConditionsMet(APawn* Pawn, APlayerController* Contro
 							break;
 						}
 					}
+					else if (Result == ENarrativeConditionResult::Pending)
+					{
+						bAnyonePending = true;
+					}
 					else
 					{
 						if (Cond->PartyConditionPolicy != EPartyConditionPolicy::AnyPlayerPasses)
 						{
-							return false;
+							return ENarrativeConditionResult::Failed;
 						}
 					}
 
 					UE_LOG(LogNarrative, Warning, TEXT("Checking %s condition, and they: %s"), *GetNameSafe(ComponentToCheck), *CondString);
 				}
 
-				//If we didn't break, no players passed 
-				if (!bAnyonePassed && Cond->PartyConditionPolicy == EPartyConditionPolicy::AnyPlayerPasses)
+				//If we didn't break, no players passed - unless someone is still pending, in which case we don't know yet
+				if (!bAnyonePassed && Cond->PartyConditionPolicy == EPartyConditionPolicy::AnyPlayerPasses && !bAnyonePending)
 				{
-					return false;
+					return ENarrativeConditionResult::Failed;
 				}
 
+				if (bAnyonePending && !bAnyonePassed)
+				{
+					bAnyPending = true;
+				}
 			}
 			else
 			{
-				if (Cond && Cond->CheckCondition(Pawn, Controller, NarrativeComponent) == Cond->bNot)
+				const ENarrativeConditionResult Result = Cond->EvaluateCondition(Pawn, Controller, NarrativeComponent);
+
+				if (Result == ENarrativeConditionResult::Failed)
 				{
-					return false;
+					return ENarrativeConditionResult::Failed;
 				}
+				
+				bAnyPending |= Result == ENarrativeConditionResult::Pending;
 			}
 
 		}
 	}
 
+	return bAnyPending ? ENarrativeConditionResult::Pending : ENarrativeConditionResult::Passed;
+}
+
+bool UNarrativeNodeBase::ResolveConditionResult(const ENarrativeConditionResult Result)
+{
+	if (Result == ENarrativeConditionResult::Pending)
+	{
+		const UNarrativeDialogueSettings* DialogueSettings = GetDefault<UNarrativeDialogueSettings>();
+		return DialogueSettings && DialogueSettings->bPendingConditionsPass;
+	}
+
+	return Result == ENarrativeConditionResult::Passed;
+}
+
+void UNarrativeNodeBase::ResetLatentConditions()
+{
+	for (auto& Cond : Conditions)
+	{
+		if (Cond && Cond->bIsLatent)
+		{
+			Cond->ResetLatentCheck();
+		}
+	}
+}
+
+ENarrativeConditionResult UNarrativeNodeBase::EvaluateConditionsThreadSafe(APawn* Pawn, APlayerController* Controller, class UNarrativeComponent* NarrativeComponent) const
+{
+	//No logging in here, since this runs on worker threads
+	if (!NarrativeComponent)
+	{
+		return ENarrativeConditionResult::Failed;
+	}
+
+	for (auto& Cond : Conditions)
+	{
+		if (Cond && !Cond->EvaluateConditionThreadSafe(Pawn, Controller, NarrativeComponent))
+		{
+			return ENarrativeConditionResult::Failed;
+		}
+	}
+
+	return ENarrativeConditionResult::Passed;
+}
+
+bool UNarrativeNodeBase::AreConditionsThreadSafe() const
+{
+	for (auto& Cond : Conditions)
+	{
+		if (Cond && !Cond->IsThreadSafe())
+		{
+			return false;
+		}
+	}
+
 	return true;
 }
@@ -16,6 +16,10 @@ void UNarrativePartyComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProper
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
 	DOREPLIFETIME(UNarrativePartyComponent, PartyMemberStates);
+
+	//Parties don't have an owning connection, and every member needs the partys quest updates regardless of the quest replication policy
+	RESET_REPLIFETIME_CONDITION(UNarrativeComponent, PendingUpdateList, COND_None);
+	RESET_REPLIFETIME_CONDITION(UNarrativeComponent, QuestSnapshot, COND_None);
 }
 
 bool UNarrativePartyComponent::BeginDialogue(TSubclassOf<class UDialogue> DialogueClass, FName StartFromID /*= NAME_None*/)
@@ -32,7 +36,7 @@ bool UNarrativePartyComponent::BeginDialogue(TSubclassOf<class UDialogue> Dialog
 			{
 				if (GroupMember)
 				{
-					GroupMember->BeginPartyDialogue(DialogueClass, CurrentDialogue->MakeIDsFromNPCNodes(CurrentDialogue->NPCReplyChain), CurrentDialogue->MakeIDsFromPlayerNodes(CurrentDialogue->AvailableResponses));
+					GroupMember->BeginPartyDialogue(DialogueClass, CurrentDialogue->PackCurrentChunk());
 				}
 			}
 
@@ -58,7 +62,7 @@ void UNarrativePartyComponent::SelectDialogueOption(class UDialogueNode_Player*
 			{
 				if (GroupMember)
 				{
-					GroupMember->ClientSelectDialogueOption(Option->GetID(), Selector);
+					GroupMember->ClientSelectDialogueOption(CurrentDialogue->PackOption(Option), Selector);
 				}
 			}
 		}
@@ -0,0 +1,227 @@
+// Copyright Narrative Tools 2022. 
+
+
+#include "NarrativeQuestActorSpawner.h"
+#include "Engine/World.h"
+#include "Engine/AssetManager.h"
+#include "GameFramework/Actor.h"
+#include "Quest.h"
+#include "NarrativeComponent.h"
+#include "NarrativeQuestSettings.h"
+
+bool UNarrativeQuestActorSpawner::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UNarrativeQuestActorSpawner::Deinitialize()
+{
+	for (auto& Request : PendingSpawns)
+	{
+		if (Request.LoadHandle.IsValid())
+		{
+			Request.LoadHandle->CancelHandle();
+		}
+	}
+
+	PendingSpawns.Empty();
+
+	for (auto& PoolKVP : ActorPool)
+	{
+		for (AActor* Actor : PoolKVP.Value.FreeActors)
+		{
+			if (IsValid(Actor))
+			{
+				Actor->Destroy();
+			}
+		}
+	}
+
+	ActorPool.Empty();
+
+	Super::Deinitialize();
+}
+
+TStatId UNarrativeQuestActorSpawner::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UNarrativeQuestActorSpawner, STATGROUP_Tickables);
+}
+
+void UNarrativeQuestActorSpawner::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (!PendingSpawns.Num())
+	{
+		return;
+	}
+
+	const UNarrativeQuestSettings* QuestSettings = GetDefault<UNarrativeQuestSettings>();
+	const double BudgetSeconds = (QuestSettings ? QuestSettings->QuestActorSpawnBudgetMs : 1.f) / 1000.0;
+	const double StartTime = FPlatformTime::Seconds();
+
+	bool bSpawnedAny = false;
+
+	for (int32 i = 0; i < PendingSpawns.Num();)
+	{
+		//Always spawn at least one actor a frame, so a single expensive actor can't stall the queue forever
+		if (bSpawnedAny && FPlatformTime::Seconds() - StartTime >= BudgetSeconds)
+		{
+			break;
+		}
+
+		//Classes still loading don't hold up the spawns behind them
+		if (PendingSpawns[i].LoadHandle.IsValid() && !PendingSpawns[i].LoadHandle->HasLoadCompleted())
+		{
+			++i;
+			continue;
+		}
+
+		//Take a copy before removing it, since spawning the actor may queue up more spawns
+		FQuestActorSpawnRequest Request = PendingSpawns[i];
+		PendingSpawns.RemoveAt(i);
+
+		UQuest* Quest = Request.Quest.Get();
+		TSubclassOf<AActor> ActorClass = Request.ActorClass.Get();
+
+		if (Request.LoadHandle.IsValid())
+		{
+			Request.LoadHandle->ReleaseHandle();
+		}
+
+		if (!Quest)
+		{
+			continue;
+		}
+
+		AActor* Actor = nullptr;
+
+		if (ActorClass)
+		{
+			Actor = SpawnRequestedActor(Request, ActorClass);
+			bSpawnedAny = true;
+		}
+		else
+		{
+			UE_LOG(LogNarrative, Warning, TEXT("Quest %s couldn't load quest actor class %s."), *GetNameSafe(Quest), *Request.ActorClass.ToString());
+		}
+
+		Quest->OnDeferredQuestActorSpawned(Actor);
+	}
+}
+
+AActor* UNarrativeQuestActorSpawner::SpawnRequestedActor(const FQuestActorSpawnRequest& Request, TSubclassOf<class AActor> ActorClass)
+{
+	UQuest* Quest = Request.Quest.Get();
+	AActor* Owner = Quest ? Quest->GetOwningController() : nullptr;
+
+	if (FQuestActorPoolEntry* PoolEntry = ActorPool.Find(ActorClass))
+	{
+		while (PoolEntry->FreeActors.Num())
+		{
+			AActor* Actor = PoolEntry->FreeActors.Pop(false);
+
+			//Something else may have destroyed the actor while it was pooled
+			if (IsValid(Actor))
+			{
+				//Put collision and ticking back how the actors class has them, rather than forcing them on for actors that start without them
+				const AActor* ActorCDO = Actor->GetClass()->GetDefaultObject<AActor>();
+
+				Actor->SetOwner(Owner);
+				Actor->SetActorTransform(Request.Transform, false, nullptr, ETeleportType::ResetPhysics);
+				Actor->SetActorHiddenInGame(false);
+				Actor->SetActorEnableCollision(ActorCDO->GetActorEnableCollision());
+				Actor->SetActorTickEnabled(ActorCDO->PrimaryActorTick.bStartWithTickEnabled);
+				return Actor;
+			}
+		}
+	}
+
+	//Go through the quest, so quests that override SpawnQuestActor get to spawn their deferred actors the same way as their other ones
+	return Quest ? Quest->SpawnQuestActor(ActorClass, Request.Transform) : nullptr;
+}
+
+int32 UNarrativeQuestActorSpawner::GetMaxPooledActors(TSubclassOf<class AActor> ActorClass) const
+{
+	if (const UNarrativeQuestSettings* QuestSettings = GetDefault<UNarrativeQuestSettings>())
+	{
+		if (const int32* MaxPooled = QuestSettings->PooledQuestActorClasses.Find(TSoftClassPtr<AActor>(ActorClass.Get())))
+		{
+			return *MaxPooled;
+		}
+	}
+
+	return 0;
+}
+
+void UNarrativeQuestActorSpawner::RequestSpawn(class UQuest* Quest, TSoftClassPtr<class AActor> ActorClass, const FTransform& Transform)
+{
+	if (!Quest || ActorClass.IsNull())
+	{
+		return;
+	}
+
+	FQuestActorSpawnRequest& Request = PendingSpawns.AddDefaulted_GetRef();
+	Request.Quest = Quest;
+	Request.ActorClass = ActorClass;
+	Request.Transform = Transform;
+
+	if (ActorClass.IsPending())
+	{
+		Request.LoadHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(ActorClass.ToSoftObjectPath());
+	}
+}
+
+void UNarrativeQuestActorSpawner::CancelSpawns(class UQuest* Quest)
+{
+	PendingSpawns.RemoveAll([Quest](const FQuestActorSpawnRequest& Request)
+	{
+		if (Request.Quest.Get() == Quest)
+		{
+			if (Request.LoadHandle.IsValid())
+			{
+				Request.LoadHandle->CancelHandle();
+			}
+
+			return true;
+		}
+
+		return false;
+	});
+}
+
+void UNarrativeQuestActorSpawner::ReleaseQuestActor(class AActor* Actor)
+{
+	if (!IsValid(Actor))
+	{
+		return;
+	}
+
+	//Most quest actors aren't pooled, so don't go adding an empty pool entry for every class that passes through here
+	const int32 MaxPooled = GetMaxPooledActors(Actor->GetClass());
+
+	if (MaxPooled <= 0)
+	{
+		Actor->Destroy();
+		return;
+	}
+
+	FQuestActorPoolEntry& PoolEntry = ActorPool.FindOrAdd(Actor->GetClass());
+
+	if (PoolEntry.FreeActors.Contains(Actor))
+	{
+		return;
+	}
+
+	if (PoolEntry.FreeActors.Num() >= MaxPooled)
+	{
+		Actor->Destroy();
+		return;
+	}
+
+	Actor->SetActorHiddenInGame(true);
+	Actor->SetActorEnableCollision(false);
+	Actor->SetActorTickEnabled(false);
+
+	PoolEntry.FreeActors.Add(Actor);
+}
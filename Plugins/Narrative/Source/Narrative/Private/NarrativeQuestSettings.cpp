@@ -6,4 +6,8 @@
 UNarrativeQuestSettings::UNarrativeQuestSettings()
 {
 	bResetTasksWhenCompleted = false;
+	QuestActorSpawnBudgetMs = 1.f;
+	AsyncBeginBudgetMs = 2.f;
+	MaxReplicatedUpdateHistory = 32;
+	QuestReplicationPolicy = ENarrativeQuestReplicationPolicy::OwnerOnly;
 }
\ No newline at end of file
@@ -9,11 +9,13 @@
 #include "NarrativeComponent.h"
 #include "NarrativeFunctionLibrary.h"
 #include "NarrativePartyComponent.h"
+#include "NarrativeQuestActorSpawner.h"
 
 UQuest::UQuest()
 {
 	QuestName = FText::FromString("My New Quest");
 	QuestDescription = FText::FromString("Enter a description for your quest here.");
+	NumPendingQuestActors = 0;
 }
 
 UWorld* UQuest::GetWorld() const
@@ -115,9 +117,26 @@ void UQuest::Deinitialize()
 		}
 	}
 
+	UNarrativeQuestActorSpawner* Spawner = GetWorld() ? GetWorld()->GetSubsystem<UNarrativeQuestActorSpawner>() : nullptr;
+
+	if (Spawner)
+	{
+		Spawner->CancelSpawns(this);
+	}
+
+	NumPendingQuestActors = 0;
+
 	for (auto& QuestActor : QuestActors)
 	{
-		QuestActor->Destroy();
+		//Pooled actor classes go back to the spawner instead of being destroyed
+		if (Spawner)
+		{
+			Spawner->ReleaseQuestActor(QuestActor);
+		}
+		else if (IsValid(QuestActor))
+		{
+			QuestActor->Destroy();
+		}
 	}
 
 	QuestActors.Empty();
@@ -343,6 +362,41 @@ AActor* UQuest::SpawnQuestActor_Implementation(TSubclassOf<class AActor> ActorCl
 	return Actor;
 }
 
+void UQuest::SpawnQuestActorDeferred(TSoftClassPtr<class AActor> ActorClass, const FTransform& ActorTransform)
+{
+	if (ActorClass.IsNull())
+	{
+		return;
+	}
+
+	if (UNarrativeQuestActorSpawner* Spawner = GetWorld() ? GetWorld()->GetSubsystem<UNarrativeQuestActorSpawner>() : nullptr)
+	{
+		++NumPendingQuestActors;
+		Spawner->RequestSpawn(this, ActorClass, ActorTransform);
+	}
+	else
+	{
+		//No spawner in editor worlds, so just spawn it now
+		SpawnQuestActor(ActorClass.LoadSynchronous(), ActorTransform);
+	}
+}
+
+void UQuest::OnDeferredQuestActorSpawned(class AActor* Actor)
+{
+	//Actors that weren't pooled were spawned by SpawnQuestActor, which will have added them already
+	if (Actor)
+	{
+		QuestActors.AddUnique(Actor);
+	}
+
+	NumPendingQuestActors = FMath::Max(NumPendingQuestActors - 1, 0);
+
+	if (!NumPendingQuestActors)
+	{
+		QuestActorsReady.Broadcast(this);
+	}
+}
+
 void UQuest::AddState(class UQuestState* State)
 {
 	States.Add(State);
@@ -7,8 +7,35 @@
 #include "LevelSequencePlayer.h"
 #include "DialogueSM.h"
 #include <MovieSceneSequencePlayer.h>
+#include "Engine/StreamableManager.h"
 #include "Dialogue.generated.h"
 
+/**How much of a dialogues line media (audio, montages) is currently being streamed in or resident in memory*/
+USTRUCT(BlueprintType)
+struct FDialogueMediaResidency
+{
+	GENERATED_BODY()
+
+	FDialogueMediaResidency()
+	{
+		PrefetchedAssets = 0;
+		ResidentAssets = 0;
+		ResidentBytes = 0;
+	}
+
+	//The number of media assets the dialogue has asked to be streamed in 
+	UPROPERTY(BlueprintReadOnly, Category = "Media Residency")
+	int32 PrefetchedAssets;
+
+	//How many of those have finished loading and are in memory
+	UPROPERTY(BlueprintReadOnly, Category = "Media Residency")
+	int32 ResidentAssets;
+
+	//Estimated memory used by the resident assets
+	UPROPERTY(BlueprintReadOnly, Category = "Media Residency")
+	int64 ResidentBytes;
+};
+
 /**Represents the configuration for a speaker in this dialogue*/
 USTRUCT(BlueprintType)
 struct FSpeakerInfo
@@ -38,7 +65,8 @@ struct FSpeakerInfo
 	class UNarrativeDialogueSequence* DefaultSpeakerShot = nullptr;
 
 	/**
-	Set this to a valid actor class if you want narrative to automatically spawn your speaker avatar in, and destroy it when the dialogue ends. 
+	Set this to a valid actor class if you want narrative to automatically spawn your speaker avatar in, and clean it up when the dialogue ends. 
+	Avatars are pooled, so see the Pooling section in the dialogue settings if you'd like to prewarm them.
 
 	If you leave this empty, narrative will try find an actor in the world with the Speaker ID added as a tag, and use that as the avatar instead.
 
@@ -74,6 +102,155 @@ struct FPlayerSpeakerInfo : public FSpeakerInfo
 	class UNarrativeDialogueSequence* SelectingReplyShot = nullptr;
 };
 
+/**A skeletal mesh on a speaker avatar, along with its anim instance so we don't need to look either up each line*/
+USTRUCT()
+struct FSpeakerMeshCache
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TWeakObjectPtr<class USkeletalMeshComponent> Mesh;
+
+	UPROPERTY()
+	TWeakObjectPtr<class UAnimInstance> AnimInstance;
+
+	//Returns the cached anim instance, re-resolving it from the mesh if the mesh has had its anim instance replaced
+	class UAnimInstance* GetAnimInstance();
+};
+
+/**The meshes tagged with Body and Face on a speaker avatar, resolved once when the avatar is linked*/
+USTRUCT()
+struct FSpeakerAvatarMeshes
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<FSpeakerMeshCache> BodyMeshes;
+
+	UPROPERTY()
+	TArray<FSpeakerMeshCache> FaceMeshes;
+};
+
+/**A chunk of dialogue as it's sent over the network. Rather than sending each nodes FName ID, nodes are sent as their index into the dialogues 
+NPCReplies/PlayerReplies packed into as few bytes as possible, along with a checksum of those tables so a client with a different version of the dialogue can tell*/
+USTRUCT()
+struct NARRATIVE_API FPackedDialogueChunk
+{
+	GENERATED_BODY()
+
+	FPackedDialogueChunk()
+	{
+		ChunkSeed = 0;
+		NodeTableChecksum = 0;
+	};
+
+	UPROPERTY()
+	TArray<int32> NPCReplyIndices;
+
+	UPROPERTY()
+	TArray<int32> PlayerReplyIndices;
+
+	UPROPERTY()
+	int32 ChunkSeed;
+
+	UPROPERTY()
+	uint32 NodeTableChecksum;
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+
+	bool operator==(const FPackedDialogueChunk& Other) const
+	{
+		return ChunkSeed == Other.ChunkSeed && NodeTableChecksum == Other.NodeTableChecksum && NPCReplyIndices == Other.NPCReplyIndices && PlayerReplyIndices == Other.PlayerReplyIndices;
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FPackedDialogueChunk> : public TStructOpsTypeTraitsBase2<FPackedDialogueChunk>
+{
+	enum
+	{
+		WithNetSerializer = true
+	};
+};
+
+/**A player reply as it's sent over the network, see FPackedDialogueChunk*/
+USTRUCT()
+struct NARRATIVE_API FPackedDialogueOption
+{
+	GENERATED_BODY()
+
+	FPackedDialogueOption()
+	{
+		OptionIndex = INDEX_NONE;
+		NodeTableChecksum = 0;
+	};
+
+	UPROPERTY()
+	int32 OptionIndex;
+
+	UPROPERTY()
+	uint32 NodeTableChecksum;
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FPackedDialogueOption> : public TStructOpsTypeTraitsBase2<FPackedDialogueOption>
+{
+	enum
+	{
+		WithNetSerializer = true
+	};
+};
+
+/**A chunk the server has worked out ahead of time, in case the player selects the option that leads to it*/
+USTRUCT()
+struct FSpeculativeDialogueChunk
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<class UDialogueNode_NPC*> NPCReplyChain;
+
+	UPROPERTY()
+	TArray<class UDialogueNode_Player*> AvailableResponses;
+};
+
+//A node event or line delegate a client held back because it came from a prediction, and whether it came from a predicted chunk or a predicted option
+struct FDeferredPredictionCallback
+{
+	bool bFromPredictedChunk = false;
+	TFunction<void()> Callback;
+};
+
+/**Where a player is up to in a dialogue. Small enough for the server to keep one for every player, so a dialogue 
+can be picked back up after a reconnect or travel without starting it again from the root*/
+USTRUCT(BlueprintType)
+struct NARRATIVE_API FNarrativeDialogueCursor
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "Dialogue Cursor")
+	TSoftClassPtr<class UDialogue> DialogueClass;
+
+	//The NPC node the current chunk started from
+	UPROPERTY(BlueprintReadOnly, Category = "Dialogue Cursor")
+	FName ChunkStartID;
+
+	//How many of the current chunks NPC lines had finished playing
+	UPROPERTY(BlueprintReadOnly, Category = "Dialogue Cursor")
+	int32 ChunkLinesPlayed = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Dialogue Cursor")
+	int32 ChunkSeed = 0;
+
+	//The IDs of the player replies selected so far, oldest first
+	UPROPERTY(BlueprintReadOnly, Category = "Dialogue Cursor")
+	TArray<FName> SelectedReplyIDs;
+
+	bool IsValid() const { return !DialogueClass.IsNull() && !ChunkStartID.IsNone(); }
+};
+
 //Created at runtime, but also used as a template, similar to UWidgetTrees in UWidgetBlueprints. 
 UCLASS(Blueprintable, BlueprintType, meta = (DisplayName="Dialogue"))
 class NARRATIVE_API UDialogue : public UObject
@@ -90,6 +267,12 @@ public:
 
 	virtual void DuplicateAndInitializeFromDialogue(UDialogue* DialogueTemplate);
 
+	//Use the nodes held by a duplicate of our template, either freshly duplicated or handed back by the dialogue cache 
+	virtual void TakeNodesFrom(UDialogue* InNodeSource);
+
+	//Give our nodes to the dialogue cache so the next dialogue of our class can reuse them. We can't be played after this 
+	virtual void ReleaseNodes();
+
 	//Dialogue assets/nodes etc have the same name on client and server, so can be referenced over the network 
 	//TODO probably don't need this anymore, as it didn't seem to work and we now resolve nodes via their FName IDs instead 
 	bool IsNameStableForNetworking() const override { return true; };
@@ -141,6 +324,13 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Configuration")
 	FName DefaultHeadBoneName;
 
+	/*
+	* Any {variables} listed here will only have GetStringVariable called for them once per dialogue, and the value will be reused for every line after that.
+	* Add variables here that won't change during a dialogue, ie {PlayerName}. 
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Configuration")
+	TArray<FString> ConstantStringVariables;
+
 	//Time to blend back into the players camera after dialogue ends
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Configuration")
 	float DialogueBlendOutTime;
@@ -174,6 +364,14 @@ public:
 	UPROPERTY()
 	TArray<class UDialogueNode_Player*> PlayerReplies;
 
+	//Checksum of the IDs in NPCReplies and PlayerReplies, baked when the dialogue is compiled. Sent along with packed chunks so we know both sides agree on node indices
+	UPROPERTY()
+	uint32 NodeTableChecksum;
+
+	//The duplicate of our template that our nodes came from
+	UPROPERTY()
+	UDialogue* NodeSource;
+
 	//Ends the current dialogue line 
 	UFUNCTION(BlueprintCallable, Category = "Dialogue")
 	virtual void EndCurrentLine();
@@ -203,8 +401,34 @@ public:
 	// a "chunk" being a chain of NPC replies, followed by the players available responses to that chain. 
 	bool GenerateDialogueChunk(UDialogueNode_NPC* NPCNode);
 
+	//True if the last generated chunk had latent conditions that hadn't finished yet, meaning the chunk used the pending condition default 
+	FORCEINLINE bool ChunkHasPendingConditions() const { return bChunkHasPendingConditions; }
+
 	//Called by the client when they have received the next dialogue chunk from the server
-	void ClientReceiveDialogueChunk(const TArray<FName>& NPCReplies, const TArray<FName>& PlayerReplies);
+	void ClientReceiveDialogueChunk(const FPackedDialogueChunk& Chunk);
+
+	//The seed used to pick which line variant each node in the current chunk plays. Sent along with the chunk so clients and the server pick the same lines
+	FORCEINLINE int32 GetChunkSeed() const { return ChunkSeed; }
+
+	//How many lines this dialogue has started playing. Sent along with skip requests so the server can tell if a request is for a line it already skipped
+	FORCEINLINE int32 GetCurrentLineIndex() const { return CurrentLineIndex; }
+
+	//[server] Make a cursor recording where we're up to, see FNarrativeDialogueCursor
+	FNarrativeDialogueCursor MakeCursor() const;
+
+	/**[server] Skip ahead to where a cursor says we were up to. Call after initializing from the cursors ChunkStartID and before playing. 
+	Returns false and leaves the chunk alone if the chunk we generated doesn't start where the cursor's did, ie because conditions changed since */
+	bool RestoreCursor(const FNarrativeDialogueCursor& Cursor);
+
+	//Whether this client should play selected options and the chunks that follow them straight away instead of waiting on the server
+	bool CanPredict() const;
+
+	//[client] Play an option we've asked the server to select without waiting for it to confirm. 
+	bool PredictSelectDialogueOption(UDialogueNode_Player* Option);
+
+	/**[client] The server has told us which option was selected. Returns true if we already predicted it and it's playing. 
+	If we predicted a different option, the prediction is undone so the servers option can be selected instead. */
+	bool ReconcileSelectedOption(const FName& OptionID);
 	
 	//Plays the current chunk of dialogue, then broadcasts the players available reponses. 
 	void Play();
@@ -234,12 +458,31 @@ public:
 	TArray<FName> MakeIDsFromNPCNodes(const TArray<UDialogueNode_NPC*> Nodes) const;
 	TArray<FName> MakeIDsFromPlayerNodes(const TArray<UDialogueNode_Player*> Nodes) const;
 
+	//IDs are only used for lookups now - chunks and options are sent over the network as packed node indices instead, which are much smaller: 
+
+	//Pack the current chunk up so it can be sent to clients
+	FPackedDialogueChunk PackCurrentChunk() const;
+
+	//Pack an option up so it can be sent to or from the server
+	FPackedDialogueOption PackOption(const UDialogueNode_Player* Option) const;
+
+	//Resolve a packed option back into its node. Returns null if it was packed by a different version of this dialogue 
+	UDialogueNode_Player* UnpackOption(const FPackedDialogueOption& PackedOption) const;
+
+	//Work out the checksum of our node tables. The compiler does this so it doesn't need to happen at runtime 
+	void BakeNodeTableChecksum();
+
+	FORCEINLINE uint32 GetNodeTableChecksum() const { return NodeTableChecksum; }
+
 	UFUNCTION(BlueprintPure, Category = "Dialogue")
 	TArray<UDialogueNode*> GetNodes() const;
 
 	//Replace any {MyVar} style variables in a dialogue line with their value 
 	virtual void ReplaceStringVariables(const class UDialogueNode* Node, const FDialogueLine& Line, FText& OutLine);
 
+	//Look up the values for all the variables in a line, calling GetStringVariable once per unique variable 
+	virtual void ResolveStringVariables(const class UDialogueNode* Node, const FDialogueLine& Line, const TArray<FDialogueTextSegment>& Segments, TMap<FString, FString>& OutValues);
+
 	//* Sometimes our actual pawn shows up in dialogues, other times we use a special avatar actor that is spawned in. Return whichever one is being used. */
 	UFUNCTION(BlueprintPure, Category = "Dialogue")
 	AActor* GetPlayerAvatar() const;
@@ -285,7 +528,7 @@ protected:
 	virtual AActor* LinkSpeakerAvatar_Implementation(const FSpeakerInfo& Info);
 	
 	/*
-	* Clean up a given actor from the world
+	* Clean up a given actor from the world. Avatars narrative spawned are given back to the dialogue pool rather than destroyed. 
 	*/
 	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "Dialogue")
 	void DestroySpeakerAvatar(const FSpeakerInfo& Info, AActor* SpeakerAvatar);
@@ -419,6 +662,32 @@ protected:
 		UFUNCTION(BlueprintCallable, Category = "Dialogue")
 	virtual void StopDialogueSequence();
 
+	//Give our sequence player back to the dialogue pool once we're done with it 
+	virtual void ReleaseDialogueSequencePlayer();
+
+	//Stream in the media for the next lines that could play, and let go of media for lines that can no longer be reached
+	virtual void UpdateMediaPrefetch();
+
+	//Let go of all the media we've prefetched
+	void ReleasePrefetchedMedia();
+
+	//Find the audio component we've already made for this speaker, or make one if this is the first line they've spoken
+	virtual class UAudioComponent* GetSpeakerAudioComponent(class USoundBase* Sound, class AActor* Speaker);
+
+	//Destroy all the audio components we've made for our speakers
+	void CleanupDialogueAudio();
+
+	//Handles keeping our prefetched line media in memory. Releasing a handle lets the media be garbage collected 
+	TMap<FSoftObjectPath, TSharedPtr<FStreamableHandle>> PrefetchedMedia;
+
+public:
+
+	/**Return how much of this dialogues line media is prefetched and resident in memory */
+	UFUNCTION(BlueprintPure, Category = "Dialogue")
+	FDialogueMediaResidency GetMediaResidency() const;
+
+protected:
+
 	UFUNCTION()
 	virtual void PlayNextNPCReply();
 
@@ -434,6 +703,12 @@ protected:
 	virtual void InitSpeakerAvatars();
 	virtual void CleanUpSpeakerAvatars();
 
+	//Resolve and cache the body and face meshes for a speaker avatar. Called when the avatar is linked, or the first time an unlinked actor speaks
+	FSpeakerAvatarMeshes& CacheSpeakerAvatarMeshes(class AActor* Avatar);
+
+	//Get the cached body and face meshes for a speaker avatar, caching them if this avatar hasn't been seen before 
+	FSpeakerAvatarMeshes& GetSpeakerAvatarMeshes(class AActor* Avatar);
+
 	//Tells the narrative component this dialogue is finished and clears the dialogue. 
 	virtual void ExitDialogue();
 
@@ -486,10 +761,25 @@ protected:
 	UPROPERTY(BlueprintReadOnly, Category = "Dialogue")
 	class UAudioComponent* DialogueAudio;
 
+	//Audio components are made once per speaker and reused for each line they say, instead of spawning a new one every line
+	UPROPERTY()
+	TMap<class AActor*, class UAudioComponent*> SpeakerAudioComponents;
+
+	//Audio component reused for any lines that don't have a speaker actor to play at
+	UPROPERTY()
+	class UAudioComponent* DialogueAudio2D;
+
 	//All spawned speaker actors, with the speaker ID mapping to that speakers avatar
 	UPROPERTY()
 	TMap<FName, class AActor*> SpeakerAvatars;
 
+	//The body and face meshes on each speaker avatar, so playing a line doesn't need to search the avatars components 
+	UPROPERTY()
+	TMap<TWeakObjectPtr<class AActor>, FSpeakerAvatarMeshes> SpeakerAvatarMeshes;
+
+	//Values of any ConstantStringVariables we've already resolved this dialogue
+	TMap<FString, FString> ConstantStringVariableCache;
+
 	//We cache the players old view target so we can set the view target back to it after dialogue ends 
 	UPROPERTY()
 	class AActor* OldViewTarget;
@@ -500,6 +790,100 @@ protected:
 	UPROPERTY()
 	FTimerHandle TimerHandle_PlayerReplyFinished;
 
+	UPROPERTY()
+	FTimerHandle TimerHandle_PendingChunk;
+
+	//If we're waiting on latent conditions before we can generate the next chunk, the player node we're generating it from, and when we started waiting
+	UPROPERTY()
+	class UDialogueNode_Player* PendingChunkPlayerNode;
+
+	float PendingChunkStartTime;
+
+	//Set by GenerateDialogueChunk if any latent conditions were still pending
+	bool bChunkHasPendingConditions;
+
+	//Rolled by the server when the dialogue begins, then derived from the previous seed and selected option so clients can predict it, see GetChunkSeed
+	int32 ChunkSeed;
+
+	//Incremented each time we start playing a line, see GetCurrentLineIndex
+	int32 CurrentLineIndex;
+
+	//The first NPC node of the current chunk, and how many of its NPC lines have finished, for MakeCursor 
+	FName ChunkStartID;
+	int32 ChunkLinesPlayed;
+
+	//Every player reply selected so far, for MakeCursor
+	TArray<FName> SelectedReplyIDs;
+
+	//[server] A new chunk has been generated, so the cursor starts again from its first node
+	void MarkChunkStart();
+
+	//The seed of the chunk that follows on from the given player reply
+	int32 MakeNextChunkSeed(const UDialogueNode_Player* PlayerNode) const;
+
+	//The first NPC reply after a player reply whose conditions pass. bOutPending is set if any of the replies conditions haven't finished yet
+	UDialogueNode_NPC* FindNextNPCReply(UDialogueNode_Player* PlayerNode, bool& bOutPending);
+
+	//Stop whatever node is currently playing without moving on to the next one, used when a new chunk replaces the current one
+	void InterruptCurrentNode();
+
+	//[client] Generate and play the chunk we expect the server to send after the given player reply
+	void PredictNextChunk(UDialogueNode_Player* PlayerNode);
+
+	//The option we've predicted was selected, and the chunk seed and responses from when we selected it in case we need to undo it
+	FName PredictedOptionID;
+	int32 PredictedOptionChunkSeed;
+
+	UPROPERTY()
+	TArray<class UDialogueNode_Player*> PredictedOptionResponses;
+
+	//The chunk we've predicted the server will send, if we're playing one
+	bool bPlayingPredictedChunk;
+	FPackedDialogueChunk PredictedChunk;
+
+	//Events and delegates can't be undone if we mispredict, so while we're playing a prediction they wait here until the server confirms it 
+	TArray<FDeferredPredictionCallback> DeferredPredictionCallbacks;
+
+	//Whether we're playing an option or chunk the server hasn't confirmed yet
+	bool IsPlayingPrediction() const;
+
+	//Hold a callback back until the server confirms the prediction we're playing 
+	void DeferUntilConfirmed(TFunction<void()>&& Callback);
+
+	//The server confirmed our predicted option, or our predicted chunk as well, so run the callbacks that were waiting on it
+	void RunConfirmedCallbacks(const bool bChunkConfirmed);
+
+	//Process a nodes events, or hold them back if the node is part of a prediction
+	void ProcessOrDeferNodeEvents(class UDialogueNode* Node, bool bStartEvents);
+
+	//Broadcast the line started/finished delegates and call the matching BlueprintNativeEvents
+	void BroadcastNPCLineStarted(class UDialogueNode_NPC* Node, const FDialogueLine& Line, const FSpeakerInfo& Speaker);
+	void BroadcastNPCLineFinished(class UDialogueNode_NPC* Node, const FDialogueLine& Line, const FSpeakerInfo& Speaker);
+	void BroadcastPlayerLineStarted(class UDialogueNode_Player* Node, const FDialogueLine& Line);
+	void BroadcastPlayerLineFinished(class UDialogueNode_Player* Node, const FDialogueLine& Line);
+
+	//Chunks we've precomputed for the options the player is choosing between, and options we found we couldn't precompute
+	UPROPERTY()
+	TMap<class UDialogueNode_Player*, FSpeculativeDialogueChunk> SpeculativeChunks;
+
+	UPROPERTY()
+	TSet<class UDialogueNode_Player*> SpeculationSkipped;
+
+	//The narrative state version our speculative chunks were generated against. If the narrative comp has moved on they may no longer be valid
+	uint32 SpeculativeStateVersion;
+
+	//Work out the chunk the given option would lead to, as if it had been played. Returns false if we can't be sure of the result ahead of time
+	bool SpeculateChunk(class UDialogueNode_Player* Option, FSpeculativeDialogueChunk& OutChunk);
+
+	//Throw away any chunks we've speculated
+	void InvalidateSpeculativeChunks();
+
+	//Generate the next chunk following on from the player reply that was selected and send it to the client. Will wait for latent conditions if required. 
+	void GenerateNextChunk(UDialogueNode_Player* PlayerNode);
+
+	//Called each frame while we're waiting on latent conditions so we can try generating the chunk again 
+	void RetryPendingChunk();
+
 	//Deintialize has been called and the dialogue should not play anymore
 	bool bDeinitialized;
 
@@ -513,6 +897,10 @@ public:
 	bool IsPartyDialogue() const;
 
 	FORCEINLINE bool IsInitialized() const { return !bDeinitialized; };
+
+	//[server] While the player is choosing a reply, spend a little time each frame working out the chunks their options lead to
+	void UpdateSpeculativeChunks();
+
 	FORCEINLINE AActor* GetCurrentSpeakerAvatar() const {return CurrentSpeakerAvatar; }
 	FORCEINLINE AActor* GetCurrentListenerAvatar() const { return CurrentListenerAvatar; }
 	FORCEINLINE UNarrativeDialogueSequence* GetCurrentDialogueSequence() const { return CurrentDialogueSequence; }
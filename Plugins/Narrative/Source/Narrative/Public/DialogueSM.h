@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "NarrativeNodeBase.h"
 #include "MovieSceneSequencePlayer.h"
+#include "UObject/ObjectSaveContext.h"
 #include "DialogueSM.generated.h"
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnDialogueNodeFinishedPlaying);
@@ -47,6 +48,29 @@ enum class ELineDuration : uint8
 	LD_Never UMETA(DisplayName = "Never")
 };
 
+/**A piece of a dialogue lines text - either literal text, or the name of a {variable} to be replaced at runtime. Only built at runtime, never saved*/
+USTRUCT()
+struct FDialogueTextSegment
+{
+	GENERATED_BODY()
+
+	FDialogueTextSegment()
+	{
+		bIsVariable = false;
+	}
+
+	FDialogueTextSegment(const FString& InText, const bool bInIsVariable) : Text(InText), bIsVariable(bInIsVariable)
+	{
+	}
+
+	//The literal text, or the variable name without its braces 
+	UPROPERTY()
+	FString Text;
+
+	UPROPERTY()
+	bool bIsVariable;
+};
+
 USTRUCT(BlueprintType)
 struct FDialogueLine
 {
@@ -57,12 +81,11 @@ public:
 	FDialogueLine()
 	{
 		Text = FText::GetEmpty();
-		FacialAnimation = nullptr;
-		DialogueSound = nullptr;
-		DialogueMontage = nullptr;
 		Shot = nullptr;
 		Duration = ELineDuration::LD_Default;
 		DurationSecondsOverride = 0.f;
+		BakedSoundDuration = -1.f;
+		bHasShot = false;
 	}
 
 	/**
@@ -87,27 +110,62 @@ public:
 	/**
 	* If a dialogue sound is selected, narrative will automatically play the sound for you in 3D space, at the location of the speaker.  
 	* If narrative can't find a speaker actor (for example if you were getting a phone call where there isn't an physical speaker) it will be played in 2D. 
+	* 
+	* Soft referenced so dialogues don't pull all of their audio into memory on load - narrative streams in the audio for upcoming lines as the dialogue plays. 
+	* Not exposed to blueprints directly, use GetDialogueLineSound instead so blueprints keep getting a sound rather than a soft reference.
 	*/
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dialogue Line")
-	class USoundBase* DialogueSound;
+	UPROPERTY(EditAnywhere, Category = "Dialogue Line")
+	TSoftObjectPtr<class USoundBase> DialogueSound;
 
 	/**
-	Narrative will play this montage on the first skeletalmeshcomponent found on your speaker with the tag "Body" added to it.
+	Narrative will play this montage on the first skeletalmeshcomponent found on your speaker with the tag "Body" added to it. Blueprints use GetDialogueLineMontage.
 	*/
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dialogue Line", meta = (DisplayName = "Body Animation"))
-	class UAnimMontage* DialogueMontage;
+	UPROPERTY(EditAnywhere, Category = "Dialogue Line", meta = (DisplayName = "Body Animation"))
+	TSoftObjectPtr<class UAnimMontage> DialogueMontage;
 
 	/**
-	Narrative will play this montage on the first skeletalmeshcomponent found on your speaker with the tag "Face" added to it. 
+	Narrative will play this montage on the first skeletalmeshcomponent found on your speaker with the tag "Face" added to it. Blueprints use GetDialogueLineFacialAnimation.
 	*/
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dialogue Line")
-	class UAnimMontage* FacialAnimation;
+	UPROPERTY(EditAnywhere, Category = "Dialogue Line")
+	TSoftObjectPtr<class UAnimMontage> FacialAnimation;
 
 	/**
 	* Shot to play for this line. Overrides speaker shot if one is set 
 	*/
 	UPROPERTY(EditAnywhere, Instanced, BlueprintReadWrite, Category = "Dialogue Line")
 	class UNarrativeDialogueSequence* Shot;
+
+	/**Grab the lines media. If the media hasn't been prefetched yet it will be loaded synchronously, which will hitch, so these are best avoided on lines that aren't playing.*/
+	class USoundBase* GetDialogueSound() const;
+	class UAnimMontage* GetDialogueMontage() const;
+	class UAnimMontage* GetFacialAnimation() const;
+
+	//Add the paths of all the media this line uses
+	void GetMediaPaths(TArray<FSoftObjectPath>& OutPaths) const;
+
+	/**The length of DialogueSound, stored when the dialogue is compiled or cooked so servers can time the line without loading the sound. -1 if it hasn't been baked.*/
+	UPROPERTY()
+	float BakedSoundDuration;
+
+	/**Whether this line had a shot when it was compiled. Servers can strip shots out, so this keeps their line timing the same as clients*/
+	UPROPERTY()
+	bool bHasShot;
+
+	//Store whether we have a shot, so servers that strip shots out still time the line the same way. Meant for editor and cook time only
+	void BakeHasShot();
+
+	//Store the length of our sound. Reads the length from the asset registry where possible, otherwise the sound is loaded if bAllowLoad 
+	//is set. Meant for editor and cook time only
+	void BakeSoundDuration(const bool bAllowLoad = true);
+
+	//Whether this line has a shot, even if the shot was stripped out because we're a server
+	bool HasShot() const;
+
+	//Get the length of our sound, using the baked duration if we have one. Returns -1 if we have no sound 
+	float GetSoundDuration() const;
+
+	//Split a string into literal and {variable} segments. Returns true if any variables were found
+	static bool TokenizeString(const FString& InString, TArray<FDialogueTextSegment>& OutSegments);
 };
 
 /**Base class for states and branches in the Dialogues state machine*/
@@ -134,6 +192,15 @@ public:
 
 	 virtual FDialogueLine GetRandomLine(const bool bStandalone) const;
 
+	 /**Pick a line the same way GetRandomLine does, but deterministically from a seed. The server sends its seed with each chunk so clients pick the same lines it does*/
+	 virtual FDialogueLine GetSeededLine(const bool bStandalone, const int32 Seed) const;
+
+	 //Which line a seed selects - INDEX_NONE for the main line, otherwise an index into AlternativeLines
+	 int32 GetLineVariantIndex(const int32 Seed) const;
+
+	 //Get the main line or one of the alternative lines, without copying any of them
+	 const FDialogueLine& GetLineVariant(const int32 VariantIndex) const;
+
 	UPROPERTY(BlueprintAssignable, Category = "Dialogue")
 	FOnDialogueNodeFinishedPlaying OnDialogueFinished;
 
@@ -173,8 +240,9 @@ public:
 
 #endif
 
-	TArray<class UDialogueNode_NPC*> GetNPCReplies(APlayerController* OwningController, APawn* OwningPawn, class UNarrativeComponent* NarrativeComponent);
-	TArray<class UDialogueNode_Player*> GetPlayerReplies(APlayerController* OwningController, APawn* OwningPawn, class UNarrativeComponent* NarrativeComponent);
+	//Get the replies whose conditions pass. If bOutHasPendingConditions is supplied it will be set to true if any replies had latent conditions that haven't finished
+	TArray<class UDialogueNode_NPC*> GetNPCReplies(APlayerController* OwningController, APawn* OwningPawn, class UNarrativeComponent* NarrativeComponent, bool* bOutHasPendingConditions = nullptr);
+	TArray<class UDialogueNode_Player*> GetPlayerReplies(APlayerController* OwningController, APawn* OwningPawn, class UNarrativeComponent* NarrativeComponent, bool* bOutHasPendingConditions = nullptr);
 
 	virtual UWorld* GetWorld() const;
 
@@ -184,8 +252,24 @@ public:
 	//Node is just used for routing and doesn't contain any dialogue 
 	bool IsRoutingNode() const;
 
+	/**Get some text of ours split into literal and {variable} segments, so ReplaceStringVariables doesn't need to search the text every time it's 
+	shown. Text is split the first time it's asked for and cached against the text itself, so each culture's translation is cached separately */
+	TSharedRef<const TArray<FDialogueTextSegment>> GetTextSegments(const FString& LineString) const;
+
+	//Bake the sound durations and shot flags our line and alternative lines are timed with. The compiler allows loading sounds the asset registry 
+	//can't tell us the length of
+	void BakeLineDurations(const bool bAllowLoad = true);
+
+#if WITH_EDITOR
+	virtual void PreSave(FObjectPreSaveContext SaveContext) override;
+#endif
+
 private:
 
+	//Map of text -> the segments it splits into. Not saved, as a copy of every line in the dialogue asset would only match the source language.
+	//Shared so the segments stay valid if replacing a variable ends up adding more text to the cache
+	mutable TMap<FString, TSharedRef<const TArray<FDialogueTextSegment>>> TextSegmentCache;
+
 #if WITH_EDITOR
 
 	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
@@ -217,7 +301,7 @@ public:
 
 	/**Grab this NPC node, appending all follow up responses to that node. Since multiple NPC replies can be linked together, 
 	we need to grab the chain of replies the NPC has to say. */
-	TArray<class UDialogueNode_NPC*> GetReplyChain(APlayerController* OwningController, APawn* OwningPawn, class UNarrativeComponent* NarrativeComponent);
+	TArray<class UDialogueNode_NPC*> GetReplyChain(APlayerController* OwningController, APawn* OwningPawn, class UNarrativeComponent* NarrativeComponent, bool* bOutHasPendingConditions = nullptr);
 
 };
 
@@ -0,0 +1,62 @@
+// Copyright Narrative Tools 2022. 
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "NarrativeActorRegistry.generated.h"
+
+/**
+ * Keeps an index of actor tags -> actors so dialogues can find speaker avatars by their tag without iterating every actor in the world. 
+ * 
+ * Actors are indexed when the world begins play, when they are spawned, and when a streaming level is added. If you change an actors tags at 
+ * runtime after it has been spawned, call RegisterActor again so the index picks up the new tags. The first lookup of a tag that finds nothing 
+ * in the index searches the world once, which catches tags added in BeginPlay. After that the tag is remembered as missing, and isn't searched 
+ * for again until an actor with that tag is registered, so tags nothing has (ie the player speaker) don't cost a world search every dialogue.
+ */
+UCLASS()
+class NARRATIVE_API UNarrativeActorRegistry : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	//Index every actor in the world. Only done once, after that we keep up to date via spawn/level events 
+	virtual void BuildIndex();
+
+	void OnActorSpawned(AActor* Actor);
+	void OnLevelAdded(ULevel* Level, UWorld* InWorld);
+
+	//Map of tag -> actors with that tag. Weak so destroyed actors just drop out of the index 
+	TMap<FName, TArray<TWeakObjectPtr<AActor>>> TaggedActors;
+
+	//Tags we've already searched the world for and found nothing with. Cleared for a tag once an actor with it is registered
+	TSet<FName> MissingTags;
+
+	bool bIndexBuilt;
+
+	FDelegateHandle ActorSpawnedHandle;
+	FDelegateHandle LevelAddedHandle;
+
+public:
+
+	UNarrativeActorRegistry();
+
+	/**Add an actor to the index under all of its tags. Call this again if you change an actors tags at runtime.*/
+	UFUNCTION(BlueprintCallable, Category = "Narrative Actor Registry")
+	void RegisterActor(AActor* Actor);
+
+	/**Remove an actor from the index. Destroyed actors are removed automatically so you don't need to call this when destroying an actor. */
+	UFUNCTION(BlueprintCallable, Category = "Narrative Actor Registry")
+	void UnregisterActor(AActor* Actor);
+
+	/**Grab all the actors in the world that have the given tag. If none are indexed under the tag, the world is searched the first time only*/
+	UFUNCTION(BlueprintCallable, Category = "Narrative Actor Registry")
+	void GetActorsWithTag(const FName& Tag, TArray<AActor*>& OutActors);
+
+};
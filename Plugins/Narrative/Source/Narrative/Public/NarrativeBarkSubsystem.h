@@ -0,0 +1,99 @@
+// Copyright Narrative Tools 2022. 
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "DialogueSM.h"
+#include "Engine/StreamableManager.h"
+#include "NarrativeBarkSubsystem.generated.h"
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnBarkStarted, class AActor*, Speaker, const FDialogueLine&, Line);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnBarkFinished, class AActor*, Speaker, const FDialogueLine&, Line);
+
+//A bark that is currently playing
+USTRUCT()
+struct FNarrativeBark
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FDialogueLine Line;
+
+	UPROPERTY()
+	class UAudioComponent* Audio = nullptr;
+
+	FTimerHandle TimerHandle_BarkFinished;
+
+	//Keeps the barks sound loading if it wasn't already in memory
+	TSharedPtr<FStreamableHandle> SoundHandle;
+};
+
+/**
+ * Plays ambient lines ("barks") on actors without beginning a dialogue.
+ *
+ * A dialogue is never instanced - lines are read straight from the dialogue classes template, so there's no template duplication, no speaker avatars,
+ * no sequence player, and nothing is replicated. Barks are purely local, so call PlayBark on each machine that should hear it, ie from a multicast
+ * or OnRep your game already has. Barks play their audio on the speaker and fire OnBarkStarted/OnBarkFinished so your UI can show subtitles.
+ *
+ * Since there's no dialogue, {variables} in bark text are not replaced. Each speaker plays one bark at a time, and barks past MaxConcurrentBarks are dropped.
+ */
+UCLASS()
+class NARRATIVE_API UNarrativeBarkSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Deinitialize() override;
+
+	//Map of speaker -> the bark they're playing
+	UPROPERTY()
+	TMap<TWeakObjectPtr<class AActor>, FNarrativeBark> ActiveBarks;
+
+	void PlayBarkSound(class AActor* Speaker, FNarrativeBark& Bark);
+	void OnBarkSoundLoaded(TWeakObjectPtr<class AActor> WeakSpeaker);
+	void BarkFinished(TWeakObjectPtr<class AActor> WeakSpeaker);
+
+	//How long a bark should play for, worked out the same way a dialogue would time the line on a server
+	float GetBarkDuration(const FDialogueLine& Line) const;
+
+	//Remove barks whose speaker has been destroyed so they don't count against the budget
+	void RemoveStaleBarks();
+
+public:
+
+	/**Play a line from a node in a dialogue, without beginning the dialogue. Alternative lines are picked from at random.
+	@param Dialogue The dialogue class the node is in
+	@param NodeID The ID of the NPC or player node to play a line from
+	@param Speaker The actor saying the line. Its sound is attached to this actor
+	@return Whether the bark started. Fails if the node couldn't be found, or we're already playing as many barks as we're allowed */
+	UFUNCTION(BlueprintCallable, Category = "Narrative Barks")
+	bool PlayBark(TSubclassOf<class UDialogue> Dialogue, const FName& NodeID, class AActor* Speaker);
+
+	/**Play a dialogue line on an actor, without beginning a dialogue.
+	@return Whether the bark started. Fails if we're already playing as many barks as we're allowed */
+	UFUNCTION(BlueprintCallable, Category = "Narrative Barks")
+	bool PlayBarkLine(const FDialogueLine& Line, class AActor* Speaker);
+
+	/**Stop the bark the speaker is playing, if any*/
+	UFUNCTION(BlueprintCallable, Category = "Narrative Barks")
+	void StopBark(class AActor* Speaker);
+
+	/**Return true if the speaker is currently playing a bark*/
+	UFUNCTION(BlueprintPure, Category = "Narrative Barks")
+	bool IsBarking(class AActor* Speaker) const;
+
+	/**How many barks are currently playing*/
+	UFUNCTION(BlueprintPure, Category = "Narrative Barks")
+	int32 GetNumActiveBarks() const { return ActiveBarks.Num(); }
+
+	/**Called when a speaker starts a bark. Bind to this to show subtitles*/
+	UPROPERTY(BlueprintAssignable, Category = "Narrative Barks")
+	FOnBarkStarted OnBarkStarted;
+
+	/**Called when a bark finishes or is stopped*/
+	UPROPERTY(BlueprintAssignable, Category = "Narrative Barks")
+	FOnBarkFinished OnBarkFinished;
+};
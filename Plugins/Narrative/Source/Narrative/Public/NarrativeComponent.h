@@ -11,6 +11,7 @@
 #include "DialogueSM.h"
 #include "Dialogue.h"
 #include "NarrativeSaveGame.h"
+#include "Engine/StreamableManager.h"
 #include "NarrativeComponent.generated.h"
 
 class UDialogueBlueprint;
@@ -71,8 +72,8 @@ public:
 
 	FNarrativeUpdate()
 	{
-		bAcked = false;
 		UpdateType = EUpdateType::UT_None;
+		Sequence = 0;
 		QuestClass = UQuest::StaticClass();
 	}
 
@@ -94,7 +95,10 @@ public:
 	UPROPERTY()
 	TArray<uint8> IntPayload;
 
-	bool bAcked; //flag client uses to prevent processing update multiple times 
+	//Counts up with every update the server sends, so clients know which updates they've already processed and whether they've missed any
+	UPROPERTY()
+	uint32 Sequence;
+
 	float CreationTime; // Timestamp server created update at
 
 	//Tell the client a quest has a new state and we need to go to that state - not called for QuestStartState, BeginQuest update handles that 
@@ -163,6 +167,48 @@ public:
 
 };
 
+/**
+Replaying the FNarrativeUpdate stream means a client that joins late would have to replay everything the player has ever done, and the
+update list would grow forever. Instead, once the list gets longer than MaxReplicatedUpdateHistory the server folds its older half into a 
+snapshot of where each quest currently is. Only updates the owning client has told the server it has processed are folded, and never ones 
+sent this frame, so the owner carries on replaying the list and ignores the snapshot rather than having its quests reloaded from under it. 
+The newest half of the list is always kept as well, for anyone else the updates are replicated to. A late joining client loads the snapshot 
+in the same way it would load a save, then only replays the updates sent since. 
+*/
+USTRUCT()
+struct FNarrativeQuestSnapshot
+{
+	GENERATED_BODY()
+
+public:
+
+	FNarrativeQuestSnapshot()
+	{
+		LastSequence = 0;
+		StateSequence = 0;
+	}
+
+	//Where each of our quests is at, saved the same way a save game does
+	UPROPERTY()
+	TArray<FNarrativeSavedQuest> Quests;
+
+	//The MasterTaskList split into two arrays since TMaps arent networked
+	UPROPERTY()
+	TArray<FString> Tasks;
+
+	UPROPERTY()
+	TArray<int32> Quantities;
+
+	//The sequence of the last update that was folded into the snapshot. Clients that have processed at least this far don't need the snapshot
+	UPROPERTY()
+	uint32 LastSequence;
+
+	//The sequence our quests were up to when the snapshot was taken. This is past LastSequence, as the snapshot is taken from our current 
+	//quests which include the updates still in the list, so a client loading the snapshot skips updates up to here
+	UPROPERTY()
+	uint32 StateSequence;
+};
+
 DECLARE_LOG_CATEGORY_EXTERN(LogNarrative, Log, All);
 
 
@@ -181,6 +227,10 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE_FourParams(FNPCDialogueLineFinished, class UD
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FPlayerDialogueLineStarted, class UDialogue*, Dialogue, class UDialogueNode_Player*, Node, const FDialogueLine&, DialogueLine);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FPlayerDialogueLineFinished, class UDialogue*, Dialogue, class UDialogueNode_Player*, Node, const FDialogueLine&, DialogueLine);
 
+//Async begins
+DECLARE_DYNAMIC_DELEGATE_OneParam(FOnDialogueBegunAsync, class UDialogue*, Dialogue);
+DECLARE_DYNAMIC_DELEGATE_OneParam(FOnQuestBegunAsync, class UQuest*, Quest);
+
 //Save/Load functionality
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnBeginSave, FString, SaveGameName);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnSaveComplete, FString, SaveGameName);
@@ -191,6 +241,31 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnLoadComplete, FString, SaveGameNa
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnJoinedParty, class UNarrativePartyComponent*, NewParty, class UNarrativePartyComponent*, LeftParty);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnLeaveParty, class UNarrativePartyComponent*, LeftParty);
 
+//A dialogue or quest being loaded and made in the background by BeginDialogueAsync or BeginQuestAsync
+USTRUCT()
+struct FNarrativeAsyncBegin
+{
+	GENERATED_BODY()
+
+	//Only one of these is set, depending on whether we're beginning a dialogue or a quest
+	TSoftClassPtr<class UDialogue> DialogueClass;
+	TSoftClassPtr<class UQuest> QuestClass;
+
+	FName StartFromID;
+
+	//Set if we're resuming a dialogue rather than beginning it, in which case the instance skips ahead to the cursor once it has been made
+	FNarrativeDialogueCursor ResumeCursor;
+
+	FOnDialogueBegunAsync OnDialogueBegun;
+	FOnQuestBegunAsync OnQuestBegun;
+
+	TSharedPtr<FStreamableHandle> LoadHandle;
+
+	//The instance, once it has been made. It gets begun on a later frame than it was made on so the two costs don't land in the same frame
+	UPROPERTY()
+	UObject* Instance = nullptr;
+};
+
 /**
 * Add this component to your Player Controller. 
 * Narrative Component acts as the connection to the Narrative system and allows you to start quests, dialogues, complete Tasks, etc.
@@ -320,6 +395,16 @@ public:
 	UPROPERTY(ReplicatedUsing = OnRep_PendingUpdateList)
 	TArray<FNarrativeUpdate> PendingUpdateList;
 
+	//The state of our quests when updates were last folded out of PendingUpdateList, so clients that join late don't need the whole update history
+	UPROPERTY(ReplicatedUsing = OnRep_QuestSnapshot)
+	FNarrativeQuestSnapshot QuestSnapshot;
+
+	//On the server, the sequence of the last update we sent. On clients, the sequence of the last update we've processed 
+	uint32 UpdateSequence;
+
+	//[server] The sequence of the last update our owning client has told us it processed. Updates past this are never folded into a snapshot
+	uint32 AckedUpdateSequence;
+
 	//A list of all the quests the player is involved in
 	UPROPERTY(VisibleAnywhere, Category = "Quests")
 	TArray<class UQuest*> QuestList;
@@ -338,6 +423,59 @@ public:
 	//We set this flag to true during loading so we don't broadcast any quest update delegates as we load quests back in
 	bool bIsLoading;
 
+	//Bumped whenever tasks are completed or quests change, so anything caching the result of conditions knows when to throw it away
+	uint32 NarrativeStateVersion;
+
+	//Our tasks or quests have changed 
+	void NarrativeStateChanged();
+
+	//The line index of the last skip request we sent or acted on, and when it happened, so we can rate limit skips
+	int32 LastSkipRequestLineIndex;
+	float LastSkipRequestTime;
+
+	//Whether enough time has passed since the last skip request to make another. The server passes a smaller IntervalScale than the client,
+	//since requests the client spaced out properly can still arrive closer together after network jitter
+	bool CanRequestSkip(const float IntervalScale = 1.f) const;
+
+	FORCEINLINE uint32 GetNarrativeStateVersion() const { return NarrativeStateVersion; }
+
+	/**Add to or take away from a tasks completion count without broadcasting, replicating, or bumping the state version. Lets the dialogue 
+	look ahead at what conditions will return once a task it knows is coming has been completed, after which it must undo the adjustment.*/
+	void AdjustTaskCountSilently(const FString& TaskName, const FString& Argument, const int32 Quantity);
+
+	//Turn a task and its argument into the string stored in the MasterTaskList
+	static FString MakeTaskString(const FString& TaskName, const FString& Argument);
+
+	//Dialogues and quests that are loading or being made in the background, in the order they were asked for
+	UPROPERTY()
+	TArray<FNarrativeAsyncBegin> PendingAsyncBegins;
+
+	//Instances an async begin has already made, which SetCurrentDialogue and MakeQuestInstance use instead of making their own
+	UPROPERTY()
+	class UDialogue* PreparedDialogue;
+
+	UPROPERTY()
+	class UQuest* PreparedQuest;
+
+	//Queue a dialogue to be loaded, made and begun in the background
+	FNarrativeAsyncBegin& AddAsyncDialogueBegin(TSoftClassPtr<class UDialogue> Dialogue, FOnDialogueBegunAsync OnBegun, FName StartFromID);
+
+	//Move our async begins along, spending no more than the dialogue or quest settings AsyncBeginBudgetMs doing so
+	void UpdateAsyncBegins();
+
+	//Do the next step of an async begin. Returns true once it's finished with, successfully or not
+	bool StepAsyncBegin(FNarrativeAsyncBegin& AsyncBegin);
+
+	//Begin a dialogue instance we've already made, instead of letting BeginDialogue make its own. The instance is cleaned up if it doesn't begin
+	bool BeginPreparedDialogue(class UDialogue* Prepared, FName StartFromID);
+
+	//Identifies our player across reconnects and travel, so their stored dialogue cursor can be found again. Remembered in ResumeKey 
+	//when a dialogue begins, since the player state may already be gone by the time we store the cursor
+	FString GetResumeKey() const;
+	FString ResumeKey;
+
+	class UNarrativeDialogueResumeSubsystem* GetResumeSubsystem() const;
+
 protected:
 
 	/** The party we're in, if any. */
@@ -356,6 +494,32 @@ protected:
 	UFUNCTION()
 	void OnRep_PendingUpdateList();
 
+	UFUNCTION()
+	void OnRep_QuestSnapshot();
+
+	//Tell the server how far through the update list we've got, so it knows which updates are safe to fold into a snapshot. Unreliable since 
+	//a later ack covers a lost one
+	UFUNCTION(Server, Unreliable)
+	void ServerAckUpdateSequence(const uint32 Sequence);
+
+	//[server] The sequence of the newest update that can be folded into a snapshot without any client having to load it
+	uint32 GetLastFoldableSequence(const int32 NumUpdatesToKeep) const;
+
+	//Load the quest snapshot in if we're behind it, then process any updates that follow on from where we are
+	void ApplyReplicatedUpdates();
+
+	//Replay an update the server sent us 
+	void ProcessNarrativeUpdate(const FNarrativeUpdate& Update);
+
+	//If quest updates are party visible, start or stop replicating them to non owners depending on whether we're in a party
+	void UpdateQuestReplicationCondition();
+
+	//Take a new quest snapshot, and remove the updates up to and including LastFoldedSequence from our update list 
+	void BakeQuestSnapshot(const uint32 LastFoldedSequence);
+
+	//Save where each of our quests is at, used by both save games and quest snapshots
+	void MakeSavedQuests(TArray<FNarrativeSavedQuest>& OutSavedQuests) const;
+
 	/**Used internally when a quest is started - Ensures that a quest asset doesn't have any errors,
 	for example a quest that has no ending, the start node has no connection, no loose nodes, etc.
 	@param OutError passed by ref, if an error is found OutError will contain the error message*/
@@ -478,6 +642,17 @@ public:
 	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Quests", meta = (AdvancedDisplay = "1"))
 	virtual class UQuest* BeginQuest(TSubclassOf<class UQuest> QuestClass, FName StartFromID = NAME_None);
 
+	/**
+	Same as BeginQuest, but the quest is loaded in the background if it isn't already, and made and begun over the following frames 
+	instead of all at once, so beginning a large quest doesn't cause a hitch. 
+
+	@param QuestAsset The quest to use
+	@param OnBegun Called once the quest has begun, or with null if it couldn't be 
+	@param StartFromID If this is set to a valid ID in the quest, we'll skip to this quest state instead of playing the quest from the start
+	*/
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Quests", meta = (AdvancedDisplay = "StartFromID"))
+	virtual void BeginQuestAsync(TSoftClassPtr<class UQuest> QuestClass, FOnQuestBegunAsync OnBegun, FName StartFromID = NAME_None);
+
 
 	/**
 	Restart a given quest. Will only actually restart the quest if it has been started.
@@ -534,16 +709,56 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Dialogues", BlueprintAuthorityOnly, meta=(AdvancedDisplay = "1"))
 	virtual bool BeginDialogue(TSubclassOf<class UDialogue> Dialogue, FName StartFromID = NAME_None);
 
+	/**
+	Same as BeginDialogue, but the dialogue is loaded in the background if it isn't already, and made and begun over the following frames 
+	instead of all at once, so beginning a large dialogue doesn't cause a hitch. 
+
+	@param Dialogue The dialogue to begin 
+	@param OnBegun Called once the dialogue has begun, or with null if it couldn't be 
+	@param StartFromID The ID of the node you want to jump to. Can be left empty and the dialogue will begin from the root node.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Dialogues", BlueprintAuthorityOnly, meta = (AdvancedDisplay = "StartFromID"))
+	virtual void BeginDialogueAsync(TSoftClassPtr<class UDialogue> Dialogue, FOnDialogueBegunAsync OnBegun, FName StartFromID = NAME_None);
+
+	/**Get where we're up to in the current dialogue. Only valid on the server. Can be kept in a save game or elsewhere and passed to ResumeDialogue later */
+	UFUNCTION(BlueprintPure, Category = "Dialogues")
+	FNarrativeDialogueCursor GetDialogueCursor() const;
+
+	/**
+	Begin a dialogue from where a cursor says the player was up to. The chunk the player was in is worked out again from its first node 
+	instead of the dialogues root, and lines that had already finished aren't played again. Like BeginDialogueAsync, the dialogue is loaded 
+	and made in the background, so resuming a dialogue that isn't in memory doesn't hitch.
+
+	@param Cursor Where the player was up to
+	@param OnResumed Called once the dialogue has been resumed, or with null if it couldn't be 
+	@return Whether the cursor was valid and the dialogue has been queued to resume
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Dialogues", BlueprintAuthorityOnly)
+	virtual bool ResumeDialogue(const FNarrativeDialogueCursor& Cursor, FOnDialogueBegunAsync OnResumed);
+
+	/**
+	If our player left in the middle of a dialogue (ie disconnected, or the server travelled), resume it. Call this once the player is back and 
+	has a player state, ie from your game modes PostLogin or HandleSeamlessTravelPlayer.
+
+	@return Whether there was a dialogue to resume. It's resumed in the background, see ResumeDialogue
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Dialogues", BlueprintAuthorityOnly)
+	virtual bool ResumeStoredDialogue();
+
+	/**Return true if our player left in the middle of a dialogue that can still be resumed with ResumeStoredDialogue*/
+	UFUNCTION(BlueprintPure, Category = "Dialogues")
+	bool HasStoredDialogue() const;
+
 	/**Used by the server to tell client to start dialogue. Also sends the initial chunk*/
 	UFUNCTION(Client, Reliable, Category = "Dialogues")
-	virtual void ClientBeginDialogue(TSubclassOf<class UDialogue> Dialogue, const TArray<FName>& NPCReplyChainIDs, const TArray<FName>& AvailableResponseIDs);
+	virtual void ClientBeginDialogue(TSubclassOf<class UDialogue> Dialogue, const FPackedDialogueChunk& Chunk);
 
 	/**[server] Begin a party dialogue for the player. */
-	virtual void BeginPartyDialogue(TSubclassOf<class UDialogue> Dialogue, const TArray<FName>& NPCReplyChainIDs, const TArray<FName>& AvailableResponseIDs);
+	virtual void BeginPartyDialogue(TSubclassOf<class UDialogue> Dialogue, const FPackedDialogueChunk& Chunk);
 
 	/**Used by the server to inform client to start party dialogue. Also sends the initial chunk*/
 	UFUNCTION(Client, Reliable, Category = "Dialogues")
-	virtual void ClientBeginPartyDialogue(TSubclassOf<class UDialogue> Dialogue, const TArray<FName>& NPCReplyChainIDs, const TArray<FName>& AvailableResponseIDs);
+	virtual void ClientBeginPartyDialogue(TSubclassOf<class UDialogue> Dialogue, const FPackedDialogueChunk& Chunk);
 
 	/**Used by the server to tell client to end dialogue*/
 	UFUNCTION(Client, Reliable, Category = "Dialogues")
@@ -555,7 +770,7 @@ public:
 
 	/**Used by the server to send valid dialogue chunks to the client*/
 	UFUNCTION(Client, Reliable, Category = "Dialogues")
-	virtual void ClientRecieveDialogueChunk(const TArray<FName>& NPCReplyChainIDs, const TArray<FName>& AvailableResponseIDs);
+	virtual void ClientRecieveDialogueChunk(const FPackedDialogueChunk& Chunk);
 
 	/**Called by the client when it tries selecting a dialogue option - the server ultimately decides if this goes through or not,
 	though the server validates replies before it sends them to you, so this should never fail */
@@ -567,11 +782,11 @@ public:
 
 	/**Allows the server to inform a client to select a dialogue option. Used by party dialogues */
 	UFUNCTION(Client, Reliable, Category = "Dialogues")
-	virtual void ClientSelectDialogueOption(const FName& OptionID, class APlayerState* Selector=nullptr);
+	virtual void ClientSelectDialogueOption(const FPackedDialogueOption& PackedOption, class APlayerState* Selector=nullptr);
 
 	/**Tell the server we've selected a dialogue option*/
 	UFUNCTION(Server, Reliable, Category = "Dialogues")
-	virtual void ServerSelectDialogueOption(const FName& OptionID);
+	virtual void ServerSelectDialogueOption(const FPackedDialogueOption& PackedOption);
 
 
 
@@ -584,9 +799,10 @@ public:
 	/**[server only] Skip the current dialogue line */
 	virtual bool SkipCurrentDialogueLine();
 
-	/**Attempt to skip the current dialogue line */
-	UFUNCTION(Server, Reliable, Category = "Dialogues")
-	virtual void ServerTrySkipCurrentDialogueLine();
+	/**Attempt to skip the current dialogue line. Unreliable since players tend to mash skip, so if a request is dropped they'll just send another.
+	@param LineIndex The clients current line index. Repeated requests to skip the same line will only skip it once */
+	UFUNCTION(Server, Unreliable, Category = "Dialogues")
+	virtual void ServerTrySkipCurrentDialogueLine(const int32 LineIndex);
 
 
 	/**
@@ -603,6 +819,13 @@ public:
 	UFUNCTION(Server, Reliable, Category = "Dialogues")
 	virtual void ServerTryExitDialogue();
 
+	/**[client] Leave a dialogue we can no longer stay in sync with, ie because the server is running a different version of it, and have the 
+	server end it too. Unlike TryExitDialogue this ignores bCanBeExited, since the dialogue can't carry on either way.*/
+	virtual void AbortDesyncedDialogue();
+
+	UFUNCTION(Server, Reliable, Category = "Dialogues")
+	virtual void ServerAbortDesyncedDialogue();
+
 	/**Return true if we're in a dialogue 
 
 	@return Whether true if we're in a dialogue, false otherwise 
@@ -23,6 +23,16 @@ enum class EPartyConditionPolicy
 	PartyLeaderPasses UMETA(DisplayName = "Party Leader Passes")
 };
 
+//The result of evaluating a condition. Latent conditions may not have an answer yet, in which case they report Pending
+UENUM(BlueprintType)
+enum class ENarrativeConditionResult : uint8
+{
+	Passed UMETA(DisplayName = "Passed"),
+	Failed UMETA(DisplayName = "Failed"),
+	/**The condition is latent and is still working out its result. */
+	Pending UMETA(DisplayName = "Pending")
+};
+
 /**
  * Narrative Conditions allow you to make conditions that dialogues and quests can then use to conditionally include/exclude nodes.
  * 
@@ -73,6 +83,35 @@ public:
 	bool CheckCondition(APawn* Pawn, APlayerController* Controller, class UNarrativeComponent* NarrativeComponent);
 	virtual bool CheckCondition_Implementation(APawn* Pawn, APlayerController* Controller, class UNarrativeComponent* NarrativeComponent);
 
+	/** Latent conditions only: kick off the work needed to find out whether this condition passes. 
+	
+	This is where expensive checks like line of sight, inventory scans or path queries should be started. You may farm the work out to 
+	a background task, but you must call FinishLatentCheck back on the game thread once you have a result. Until then the condition 
+	reports Pending, and dialogue will either wait for it or fall back to the default in the Narrative Dialogue Settings. 
+
+	The default implementation just runs CheckCondition and finishes immediately. 
+	*/
+	UFUNCTION(BlueprintNativeEvent, Category = "Conditions")
+	void BeginLatentCheck(APawn* Pawn, APlayerController* Controller, class UNarrativeComponent* NarrativeComponent);
+	virtual void BeginLatentCheck_Implementation(APawn* Pawn, APlayerController* Controller, class UNarrativeComponent* NarrativeComponent);
+
+	/**Latent conditions only: call this once your latent check has its result. Must be called on the game thread. bNot is applied for you. */
+	UFUNCTION(BlueprintCallable, Category = "Conditions")
+	void FinishLatentCheck(class UNarrativeComponent* NarrativeComponent, const bool bPassed);
+
+	/**Run the condition and apply bNot. Latent conditions will start their check if it hasn't been started, and return Pending until it finishes.*/
+	ENarrativeConditionResult EvaluateCondition(APawn* Pawn, APlayerController* Controller, class UNarrativeComponent* NarrativeComponent);
+
+	/**Run a thread safe condition off the game thread and apply bNot. Calls the native CheckCondition straight away rather than going through 
+	ProcessEvent, which isn't safe off the game thread. Only call this if IsThreadSafe returned true. */
+	bool EvaluateConditionThreadSafe(APawn* Pawn, APlayerController* Controller, class UNarrativeComponent* NarrativeComponent);
+
+	/**Forget any latent results we've got, so the next evaluation starts a fresh check */
+	void ResetLatentCheck();
+
+	/**Return true if this condition can safely be evaluated off the game thread. Only native, non latent conditions can, and never blueprint subclasses.*/
+	virtual bool IsThreadSafe() const;
+
 	/**Define the text that will show up on a node if this condition is added to it */
 	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "Conditions")
 	FString GetGraphDisplayText();
@@ -89,4 +128,25 @@ public:
 	the quest on their own narrative component, but if you wanted to check if the party itself had completed the quest before you'd check this box.*/
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Parties")
 	EPartyConditionPolicy PartyConditionPolicy = EPartyConditionPolicy::AnyPlayerPasses;
+
+	/**
+	If true, this condition doesn't answer straight away. Instead narrative calls BeginLatentCheck, and the condition reports Pending until 
+	FinishLatentCheck is called. Use this for expensive checks that you don't want stalling the game thread when a dialogue opens. 
+	*/
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Conditions")
+	bool bIsLatent = false;
+
+	/**
+	C++ conditions only: set this to true if CheckCondition only reads from the narrative component and the actors passed in, and never 
+	modifies anything. Dialogues with lots of replies can then check thread safe conditions in parallel across the task graph. 
+	Ignored for blueprint conditions, since blueprints have to run on the game thread.
+	*/
+	UPROPERTY(EditDefaultsOnly, Category = "Conditions")
+	bool bThreadSafe = false;
+
+private:
+
+	//Results of finished latent checks, and the checks that are still in flight. Keyed by comp since party conditions run against several comps
+	TMap<TWeakObjectPtr<class UNarrativeComponent>, bool> LatentResults;
+	TSet<TWeakObjectPtr<class UNarrativeComponent>> PendingLatentChecks;
 };
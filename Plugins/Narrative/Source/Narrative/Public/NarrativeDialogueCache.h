@@ -0,0 +1,90 @@
+// Copyright Narrative Tools 2022. 
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "NarrativeDialogueCache.generated.h"
+
+//A dialogues duplicated nodes, waiting to be reused by the next dialogue of the same class
+USTRUCT()
+struct FCachedDialogueNodes
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TSubclassOf<class UDialogue> DialogueClass;
+
+	//The duplicate of the dialogue template that owns the nodes
+	UPROPERTY()
+	class UDialogue* Nodes = nullptr;
+
+	int64 Bytes = 0;
+};
+
+/**
+ * Beginning a dialogue duplicates its classes dialogue template, which for a big dialogue is a deep copy of hundreds of objects. When a dialogue
+ * ends it hands its duplicated nodes to this cache, so the next dialogue of the same class (ie talking to the same vendor again) can reset and
+ * reuse them instead of duplicating the template again.
+ *
+ * The cache is least recently used first out, and is bounded by both MaxCachedDialogues and MaxDialogueCacheMemoryKB in the dialogue settings.
+ * Use narrative.ReportDialogueCache to see how often it is being hit.
+ */
+UCLASS()
+class NARRATIVE_API UNarrativeDialogueCache : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Deinitialize() override;
+
+	//Cached nodes, least recently used first
+	UPROPERTY()
+	TArray<FCachedDialogueNodes> Entries;
+
+	//Nodes are the same size for every dialogue of a class, so they're only measured once
+	TMap<TWeakObjectPtr<UClass>, int64> BytesPerClass;
+
+	int64 CachedBytes;
+	int32 Hits;
+	int32 Misses;
+
+	//Clear out anything the last dialogue to use the nodes left behind, putting anything blueprints could have changed back to how the template has it
+	void ResetNodes(TSubclassOf<class UDialogue> DialogueClass, class UDialogue* Nodes);
+
+	//Add up the memory used by a set of nodes
+	int64 MeasureNodes(class UDialogue* Nodes);
+
+	//Throw away the least recently used nodes until we're back within our limits
+	void EvictToLimits();
+
+public:
+
+	UNarrativeDialogueCache();
+
+	/**Take some cached nodes for a dialogue of the given class out of the cache, moving them into the dialogue. Returns null if there weren't any */
+	class UDialogue* AcquireNodes(TSubclassOf<class UDialogue> DialogueClass, class UDialogue* NewOwner);
+
+	/**Give a dialogues nodes to the cache once it has finished with them */
+	void ReleaseNodes(TSubclassOf<class UDialogue> DialogueClass, class UDialogue* Nodes);
+
+	/**Whether the cache has nodes waiting for a dialogue of the given class */
+	bool HasCachedNodes(TSubclassOf<class UDialogue> DialogueClass) const;
+
+	/**Throw away everything in the cache */
+	UFUNCTION(BlueprintCallable, Category = "Narrative Dialogue Cache")
+	void EmptyCache();
+
+	/**The fraction of dialogues begun that reused cached nodes, from 0 to 1 */
+	UFUNCTION(BlueprintPure, Category = "Narrative Dialogue Cache")
+	float GetHitRate() const;
+
+	/**Roughly how much memory the cached nodes are using */
+	UFUNCTION(BlueprintPure, Category = "Narrative Dialogue Cache")
+	int64 GetCachedBytes() const { return CachedBytes; }
+
+	/**Log how the cache is doing */
+	void LogReport() const;
+};
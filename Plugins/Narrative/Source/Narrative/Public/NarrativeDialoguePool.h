@@ -0,0 +1,78 @@
+// Copyright Narrative Tools 2022. 
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include <MovieSceneSequencePlayer.h>
+#include "NarrativeDialoguePool.generated.h"
+
+//All the free avatars of a given class 
+USTRUCT()
+struct FNarrativeAvatarPoolEntry
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<class AActor*> FreeAvatars;
+};
+
+/**
+ * Pools the actors that dialogues spawn in, so that talking to the same NPC over and over doesn't keep paying for actor spawning 
+ * and destruction. Speaker avatars are kept per class - releasing an avatar hides it and resets it instead of destroying it. 
+ * 
+ * Also keeps a pool of level sequence actors, so dialogue shots can start playing without spawning a sequence player first. 
+ */
+UCLASS()
+class NARRATIVE_API UNarrativeDialoguePool : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+
+	//Hide and reset an avatar so it can sit in the pool until it is needed again
+	virtual void ResetAvatar(class AActor* Avatar);
+
+	//Map of avatar class -> free avatars of that class
+	UPROPERTY()
+	TMap<TSubclassOf<class AActor>, FNarrativeAvatarPoolEntry> AvatarPool;
+
+	//Sequence actors that aren't being used by a dialogue 
+	UPROPERTY()
+	TArray<class ALevelSequenceActor*> FreeSequenceActors;
+
+	class ALevelSequenceActor* SpawnSequenceActor();
+
+public:
+
+	/**Grab an avatar of the given class from the pool, spawning one if the pool is empty. */
+	UFUNCTION(BlueprintCallable, Category = "Narrative Dialogue Pool")
+	class AActor* AcquireAvatar(TSubclassOf<class AActor> AvatarClass, const FTransform& Transform, class AActor* Owner);
+
+	/**Give an avatar back to the pool. If the pool for its class is full the avatar is destroyed instead. */
+	UFUNCTION(BlueprintCallable, Category = "Narrative Dialogue Pool")
+	void ReleaseAvatar(class AActor* Avatar);
+
+	/**Spawn avatars of the given class ahead of time so the first dialogue that uses them doesn't need to spawn anything. Limited by MaxPooledAvatarsPerClass */
+	UFUNCTION(BlueprintCallable, Category = "Narrative Dialogue Pool")
+	void PrewarmAvatars(TSubclassOf<class AActor> AvatarClass, const int32 Count);
+
+	/**Return true if the avatar is currently sitting unused in the pool */
+	bool IsAvatarPooled(class AActor* Avatar) const;
+
+	/**Grab a level sequence actor to play dialogue shots on, spawning one if the pool is empty. */
+	UFUNCTION(BlueprintCallable, Category = "Narrative Dialogue Pool")
+	class ALevelSequenceActor* AcquireSequenceActor(const FMovieSceneSequencePlaybackSettings& PlaybackSettings);
+
+	/**Stop a sequence actor and give it back to the pool. If the pool is full the sequence actor is destroyed instead. */
+	UFUNCTION(BlueprintCallable, Category = "Narrative Dialogue Pool")
+	void ReleaseSequenceActor(class ALevelSequenceActor* SequenceActor);
+
+	/**Spawn sequence actors ahead of time so the first line of a dialogue doesn't hitch. Limited by MaxPooledSequenceActors */
+	UFUNCTION(BlueprintCallable, Category = "Narrative Dialogue Pool")
+	void PrewarmSequenceActors(const int32 Count);
+};
@@ -0,0 +1,79 @@
+// Copyright Narrative Tools 2022. 
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "Engine/StreamableManager.h"
+#include "NarrativeDialoguePrefetchComponent.generated.h"
+
+/**
+ * Add this to an NPC to load its dialogues in the background as players walk up to it, instead of loading them synchronously when the dialogue begins.
+ *
+ * Once a player comes within PrefetchRadius the dialogue classes are loaded asynchronously, and their templates readied so beginning them doesn't
+ * need to do any loading. A duplicate of each template's nodes is also put in the dialogue cache, so the first BeginDialogue doesn't have to
+ * duplicate the template itself. Clients also stream in the media for the first line of each dialogue. Once no player has been in range for ReleaseTimeout
+ * seconds everything is let go of again. Reference your dialogues softly elsewhere on the NPC, otherwise they'll be loaded along with it anyway.
+ */
+UCLASS( ClassGroup=(Narrative), DisplayName = "Narrative Dialogue Prefetch Component", meta=(BlueprintSpawnableComponent) )
+class NARRATIVE_API UNarrativeDialoguePrefetchComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+
+	UNarrativeDialoguePrefetchComponent();
+
+	/**The dialogues this NPC can begin*/
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Prefetch")
+	TArray<TSoftClassPtr<class UDialogue>> Dialogues;
+
+	/**Players within this distance of the NPC cause its dialogues to be loaded in*/
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Prefetch", meta = (ClampMin = 0))
+	float PrefetchRadius;
+
+	/**Once no players are in range, how many seconds to wait before letting go of the dialogues*/
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Prefetch", meta = (ClampMin = 0))
+	float ReleaseTimeout;
+
+	/**If true, the audio and animations for the first line of each dialogue will be streamed in too*/
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Prefetch")
+	bool bPrefetchFirstLineMedia;
+
+	/**Start loading our dialogues, regardless of whether a player is in range*/
+	UFUNCTION(BlueprintCallable, Category = "Prefetch")
+	void Prefetch();
+
+	/**Let go of our dialogues. They'll be loaded again next time a player comes in range*/
+	UFUNCTION(BlueprintCallable, Category = "Prefetch")
+	void ReleasePrefetch();
+
+	/**Return true if all of our dialogues have finished loading and are ready to begin*/
+	UFUNCTION(BlueprintPure, Category = "Prefetch")
+	bool IsPrefetched() const;
+
+	/**Grab one of our dialogues if it has finished loading, so it can be passed to BeginDialogue. Returns null if it isn't loaded yet*/
+	UFUNCTION(BlueprintPure, Category = "Prefetch")
+	TSubclassOf<class UDialogue> GetPrefetchedDialogue(const int32 Index) const;
+
+protected:
+
+	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction) override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	//Return true if any player pawn we know about is within the prefetch radius
+	bool IsPlayerInRange() const;
+
+	//Our dialogues have loaded, get their templates ready to go
+	void OnDialoguesLoaded();
+
+	TSharedPtr<FStreamableHandle> DialogueHandle;
+	TSharedPtr<FStreamableHandle> MediaHandle;
+
+	//Keeps the dialogue classes alive while we're holding onto them
+	UPROPERTY()
+	TArray<TSubclassOf<class UDialogue>> PreparedDialogues;
+
+	//The last time a player was in range
+	float LastInRangeTime;
+};
@@ -0,0 +1,55 @@
+// Copyright Narrative Tools 2022. 
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Dialogue.h"
+#include "NarrativeDialogueResumeSubsystem.generated.h"
+
+//A players dialogue cursor, and when it was stored
+USTRUCT()
+struct FStoredDialogueCursor
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FNarrativeDialogueCursor Cursor;
+
+	double StoredTime = 0.0;
+};
+
+/**
+ * Keeps the dialogue cursor of every player whose narrative component went away mid-dialogue, ie because they disconnected or the server travelled.
+ * Lives on the game instance so it outlasts both the player controller and the world. Cursors are thrown away after DialogueResumeTimeout seconds.
+ *
+ * Call ResumeStoredDialogue on the players new narrative component once they're back to carry on where they left off.
+ */
+UCLASS()
+class NARRATIVE_API UNarrativeDialogueResumeSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	//Map of player key -> their cursor, see UNarrativeComponent::GetResumeKey
+	UPROPERTY()
+	TMap<FString, FStoredDialogueCursor> StoredCursors;
+
+	//Throw away cursors that have been stored for longer than the timeout
+	void RemoveExpiredCursors();
+
+public:
+
+	/**Keep a players cursor until they come back for it */
+	void StoreCursor(const FString& PlayerKey, const FNarrativeDialogueCursor& Cursor);
+
+	/**Take a players cursor out of the store. Returns false if there wasn't one, or it had expired */
+	bool TakeCursor(const FString& PlayerKey, FNarrativeDialogueCursor& OutCursor);
+
+	/**Forget a players cursor, ie because they've begun a different dialogue since */
+	void DiscardCursor(const FString& PlayerKey);
+
+	/**Return true if a player has a cursor waiting for them */
+	bool HasCursor(const FString& PlayerKey) const;
+};
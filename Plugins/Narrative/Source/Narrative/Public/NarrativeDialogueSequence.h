@@ -181,6 +181,9 @@ class NARRATIVE_API UNarrativeDialogueSequence : public UObject
 		virtual void BeginPlaySequence(class ALevelSequenceActor* InSequenceActor, class UDialogue* InDialogue, class AActor* InSpeaker, class AActor* InListener);
 		virtual void EndSequence();
 
+		//Shots are purely presentation, so servers can skip loading them along with their level sequences
+		virtual bool NeedsLoadForServer() const override;
+
 		FORCEINLINE TArray<class ULevelSequence*> GetSequenceAssets() const { return SequenceAssets;}
 		FORCEINLINE FMovieSceneSequencePlaybackSettings GetPlaybackSettings() const {return PlaybackSettings;}
 
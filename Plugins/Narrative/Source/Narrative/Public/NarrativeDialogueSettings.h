@@ -34,6 +34,86 @@ public:
 	UPROPERTY(EditAnywhere, config, Category = "Dialogue Settings")
 	bool bAutoSelectSingleResponse;
 
+	//If a latent condition still hasn't finished by the time we stop waiting for it, should it be treated as passed? 
+	UPROPERTY(EditAnywhere, config, Category = "Conditions")
+	bool bPendingConditionsPass;
+
+	//How long the server will wait for latent conditions to finish before generating the next chunk of dialogue anyway. Set to 0 to never wait.
+	//The first chunk of a dialogue never waits, since BeginDialogue needs an answer straight away. 
+	UPROPERTY(EditAnywhere, config, Category = "Conditions", meta = (ClampMin = 0))
+	float PendingConditionTimeout;
+
+	//If a node has at least this many replies and all of their conditions are thread safe, the conditions will be checked in parallel 
+	UPROPERTY(EditAnywhere, config, Category = "Conditions", meta = (ClampMin = 2))
+	int32 ParallelConditionReplyThreshold;
+
+	//If true, speaker avatars that narrative spawns in will be hidden and kept around for the next dialogue instead of destroyed 
+	UPROPERTY(EditAnywhere, config, Category = "Pooling")
+	bool bPoolSpeakerAvatars;
+
+	//The most unused avatars of any one class to keep around. Avatars released once the pool is full are destroyed.
+	UPROPERTY(EditAnywhere, config, Category = "Pooling", meta = (ClampMin = 0, EditCondition = "bPoolSpeakerAvatars"))
+	int32 MaxPooledAvatarsPerClass;
+
+	//Avatar classes to spawn into the pool when the world begins play, and how many of each. Saves a hitch the first time a dialogue using them opens
+	UPROPERTY(EditAnywhere, config, Category = "Pooling", meta = (EditCondition = "bPoolSpeakerAvatars"))
+	TMap<TSoftClassPtr<class AActor>, int32> PrewarmedSpeakerAvatars;
+
+	//How many level sequence actors to spawn into the pool when the world begins play. One is usually enough unless several dialogues play at once
+	UPROPERTY(EditAnywhere, config, Category = "Pooling", meta = (ClampMin = 0))
+	int32 PrewarmedSequenceActors;
+
+	//The most unused level sequence actors to keep around. Sequence actors released once the pool is full are destroyed.
+	UPROPERTY(EditAnywhere, config, Category = "Pooling", meta = (ClampMin = 0))
+	int32 MaxPooledSequenceActors;
+
+	//How many finished dialogues worth of nodes to keep so beginning the same dialogue again doesn't need to duplicate its template. Set to 0 to disable.
+	//Between uses every node property blueprints can write to (ie Line, DirectedAtSpeakerID, bIsSkippable) is copied back from the matching node in
+	//the dialogue template, and latent condition results are thrown away so every condition is checked again by the next dialogue.
+	UPROPERTY(EditAnywhere, config, Category = "Pooling", meta = (ClampMin = 0))
+	int32 MaxCachedDialogues;
+
+	//The most memory the dialogue cache can use. The least recently used dialogues are thrown away once it goes over this.
+	UPROPERTY(EditAnywhere, config, Category = "Pooling", meta = (ClampMin = 0))
+	int32 MaxDialogueCacheMemoryKB;
+
+	//The most barks the bark subsystem will play at once. Barks started once this many are playing are dropped, which keeps crowds of NPCs from overloading audio 
+	UPROPERTY(EditAnywhere, config, Category = "Barks", meta = (ClampMin = 0))
+	int32 MaxConcurrentBarks;
+
+	//How many milliseconds a frame BeginDialogueAsync can spend making and beginning dialogues once they've loaded. At least one step is always
+	//taken each frame, so a single dialogue that takes longer than this still gets begun. Quests use AsyncBeginBudgetMs in the quest settings. 
+	UPROPERTY(EditAnywhere, config, Category = "Async Loading", meta = (ClampMin = 0))
+	float AsyncBeginBudgetMs;
+
+	//How many lines ahead of the current line narrative will stream in audio and animations for. Media for lines that can no longer be reached is released. 
+	UPROPERTY(EditAnywhere, config, Category = "Media Streaming", meta = (ClampMin = 0))
+	int32 DialogueMediaPrefetchLines;
+
+	//If true, clients will play the option they select and the chunk that follows it straight away instead of waiting a round trip for the server.
+	//If the server disagrees, the client switches over to whatever the server sent. Party dialogues are never predicted.
+	UPROPERTY(EditAnywhere, config, Category = "Server")
+	bool bPredictDialogueOnClients;
+
+	//While the player is choosing a reply, the server will spend up to this many milliseconds a frame working out the chunk each option leads to, 
+	//so it can send it the moment the option finishes playing. Options with events are never precomputed. Set to 0 to disable. 
+	UPROPERTY(EditAnywhere, config, Category = "Server", meta = (ClampMin = 0))
+	float SpeculativeChunkBudgetMs;
+
+	//Clients can ask the server to skip a line at most once every this many seconds. Skip requests are unreliable, so mashing skip can't flood the reliable buffer.
+	//The server allows requests half this far apart to leave room for network jitter
+	UPROPERTY(EditAnywhere, config, Category = "Server", meta = (ClampMin = 0))
+	float MinSkipRequestInterval;
+
+	//How many seconds the server keeps a players place in a dialogue after they leave mid-dialogue, for ResumeStoredDialogue
+	UPROPERTY(EditAnywhere, config, Category = "Server", meta = (ClampMin = 0))
+	float DialogueResumeTimeout;
+
+	//If true, dialogue shots and the level sequences they use won't be cooked into or loaded on dedicated servers, which never play them.
+	//Line timing is unaffected, as lines store whether they had a shot when the dialogue is compiled. Use narrative.ReportTemplateMemory to compare.
+	UPROPERTY(EditAnywhere, config, Category = "Server")
+	bool bStripPresentationDataOnServer;
+
 	//Expiremental - won't autoarrange old dialogues, and you'll need to move your nodes into the correct position yourself. 
 	//Also makes dialogue nodes sort themselves from left to right instead of top to bottom
 
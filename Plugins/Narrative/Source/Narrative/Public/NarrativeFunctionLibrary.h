@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "Kismet/BlueprintFunctionLibrary.h"
+#include "DialogueSM.h"
 #include "NarrativeFunctionLibrary.generated.h"
 
 /**
@@ -54,4 +55,16 @@ public:
 	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Narrative")
 	static FString MakeDisplayString(const FString& String);
 
+	//Grab a dialogue lines sound. Lines soft reference their media, so this loads the sound if narrative hasn't streamed it in yet, which will hitch
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Narrative", meta = (DisplayName = "Get Dialogue Sound"))
+	static class USoundBase* GetDialogueLineSound(const FDialogueLine& Line);
+
+	//Grab a dialogue lines body animation, loading it if narrative hasn't streamed it in yet
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Narrative", meta = (DisplayName = "Get Body Animation"))
+	static class UAnimMontage* GetDialogueLineMontage(const FDialogueLine& Line);
+
+	//Grab a dialogue lines facial animation, loading it if narrative hasn't streamed it in yet
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Narrative", meta = (DisplayName = "Get Facial Animation"))
+	static class UAnimMontage* GetDialogueLineFacialAnimation(const FDialogueLine& Line);
+
 };
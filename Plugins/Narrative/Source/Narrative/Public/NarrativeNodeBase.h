@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "UObject/NoExportTypes.h"
 #include "NarrativeEvent.h"
+#include "NarrativeCondition.h"
 #include "NarrativeNodeBase.generated.h"
 
 /**
@@ -25,6 +26,8 @@ public:
 
 #endif 
 
+	virtual void PostLoad() override;
+
 	//This probably isn't needed anymore because we use node IDs to reference nodes over the network. TODO look at removing 
 	bool IsNameStableForNetworking() const override {return true;};
 	bool IsSupportedForNetworking() const override{return true;};
@@ -38,10 +41,25 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Events & Conditions")
 	void ProcessEvents(APawn* Pawn, APlayerController* Controller, class UNarrativeComponent* NarrativeComponent, const EEventRuntime Runtime);
 
-	//Check if all the conditions are met on this quest/dialogue node
+	//Check if all the conditions are met on this quest/dialogue node. Latent conditions that haven't finished use the default set in the dialogue settings
 	UFUNCTION(BlueprintCallable, Category = "Events & Conditions")
 	bool AreConditionsMet(APawn* Pawn, APlayerController* Controller, class UNarrativeComponent* NarrativeComponent);
 
+	//Check the conditions on this node, returning Pending if any latent conditions haven't finished and none of the others have failed
+	ENarrativeConditionResult EvaluateConditions(APawn* Pawn, APlayerController* Controller, class UNarrativeComponent* NarrativeComponent);
+
+	//Resolve a pending result using the default set in the dialogue settings 
+	static bool ResolveConditionResult(const ENarrativeConditionResult Result);
+
+	//Throw away the results of any latent conditions on this node so they get checked again
+	void ResetLatentConditions();
+
+	//Return true if every condition on this node is thread safe, meaning EvaluateConditionsThreadSafe can be called off the game thread
+	bool AreConditionsThreadSafe() const;
+
+	//Check the conditions on this node from off the game thread. Only valid if AreConditionsThreadSafe returned true, and doesn't support parties
+	ENarrativeConditionResult EvaluateConditionsThreadSafe(APawn* Pawn, APlayerController* Controller, class UNarrativeComponent* NarrativeComponent) const;
+
 	/**
 	This node only appears if the following conditions are met. Note that currently only dialogues support conditions, they won't do anything in quests!
 	
@@ -53,15 +71,22 @@ public:
 	/**Events that should fire when this is reached. These are supported by both quests and dialogues, and will fire on both client and server. */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Instanced, Category = "Events & Conditions")
 	TArray<class UNarrativeEvent*> Events;
+
+	//Split Events into the events that run at the start and the events that run at the end. The compiler does this, so ProcessEvents doesn't have to filter every time
+	void PartitionEvents();
 	
 	void SetID(const FName& NewID) 
 	{
 		ID = NewID;
 		EnsureUniqueID();
+		UpdateStableIDHash();
 	};
 
 	FORCEINLINE FName GetID() const {return ID;};
 
+	//A hash of our ID that's the same in every process. GetTypeHash(FName) isn't, so use this for anything the client and server need to agree on
+	FORCEINLINE uint32 GetStableIDHash() const {return StableIDHash;};
+
 protected:
 
 	virtual void EnsureUniqueID(){};
@@ -70,4 +95,21 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Details", meta = (DisplayPriority = 0))
 	FName ID;
 
+	//Worked out whenever our ID changes or we're loaded, so nothing at runtime has to build strings to hash our ID 
+	UPROPERTY()
+	uint32 StableIDHash;
+
+	void UpdateStableIDHash();
+
+	//Events that run when the node starts/ends. Built from Events by PartitionEvents, events with a runtime of Both will be in both lists
+	UPROPERTY()
+	TArray<class UNarrativeEvent*> StartEvents;
+
+	UPROPERTY()
+	TArray<class UNarrativeEvent*> EndEvents;
+
+	//False for nodes compiled before events were partitioned, so we know to partition them on load
+	UPROPERTY()
+	bool bEventsPartitioned = false;
+
 };
@@ -0,0 +1,83 @@
+// Copyright Narrative Tools 2022. 
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Engine/StreamableManager.h"
+#include "NarrativeQuestActorSpawner.generated.h"
+
+//A quest actor waiting to be spawned
+USTRUCT()
+struct FQuestActorSpawnRequest
+{
+	GENERATED_BODY()
+
+	//The quest that asked for the actor, which will own it once it has spawned
+	TWeakObjectPtr<class UQuest> Quest;
+
+	TSoftClassPtr<class AActor> ActorClass;
+
+	FTransform Transform;
+
+	//Keeps the actors class loading if it wasn't already in memory
+	TSharedPtr<FStreamableHandle> LoadHandle;
+};
+
+//All the free quest actors of a given class
+USTRUCT()
+struct FQuestActorPoolEntry
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<class AActor*> FreeActors;
+};
+
+/**
+ * Spawns the actors quests ask for via SpawnQuestActorDeferred, a few at a time, so a quest that places lots of props and NPCs when it
+ * reaches a state doesn't spawn them all in the same frame. Classes that aren't loaded yet are loaded in the background first.
+ *
+ * Quest actor classes listed in the quest settings PooledQuestActorClasses are pooled - when the quest that spawned them ends they're
+ * hidden and kept around for the next quest that wants one, instead of being destroyed.
+ */
+UCLASS()
+class NARRATIVE_API UNarrativeQuestActorSpawner : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	//Spawns we haven't got to yet, in the order they were asked for
+	TArray<FQuestActorSpawnRequest> PendingSpawns;
+
+	//Map of actor class -> free actors of that class
+	UPROPERTY()
+	TMap<TSubclassOf<class AActor>, FQuestActorPoolEntry> ActorPool;
+
+	//Spawn the actor for a request, taking it from the pool if we can and otherwise having the quest spawn it via SpawnQuestActor
+	class AActor* SpawnRequestedActor(const FQuestActorSpawnRequest& Request, TSubclassOf<class AActor> ActorClass);
+
+	//How many actors of the given class we're allowed to keep pooled
+	int32 GetMaxPooledActors(TSubclassOf<class AActor> ActorClass) const;
+
+public:
+
+	/**Queue a quest actor to be spawned. Once it has, it's given to the quest which manages its lifetime like any other quest actor. */
+	void RequestSpawn(class UQuest* Quest, TSoftClassPtr<class AActor> ActorClass, const FTransform& Transform);
+
+	/**Throw away any spawns the given quest asked for that haven't happened yet */
+	void CancelSpawns(class UQuest* Quest);
+
+	/**Pool the actor if its class is pooled and the pool isn't full, otherwise destroy it */
+	void ReleaseQuestActor(class AActor* Actor);
+
+	/**How many actors are waiting to be spawned, across every quest */
+	UFUNCTION(BlueprintPure, Category = "Narrative Quest Actors")
+	int32 GetNumPendingSpawns() const { return PendingSpawns.Num(); }
+};
@@ -6,6 +6,20 @@
 #include "UObject/NoExportTypes.h"
 #include "NarrativeQuestSettings.generated.h"
 
+/**Defines which connections a narrative components quest updates are replicated to*/
+UENUM()
+enum class ENarrativeQuestReplicationPolicy : uint8
+{
+	/**Only the player that owns the component gets its quest updates*/
+	OwnerOnly UMETA(DisplayName = "Owner Only"),
+
+	/**The owner gets the quest updates, and so does everyone the component is relevant to while the player is in a party*/
+	Party UMETA(DisplayName = "Party Visible"),
+
+	/**Everyone the component is relevant to gets its quest updates*/
+	Everyone UMETA(DisplayName = "Everyone")
+};
+
 /**
  * Runtime quest settings for narrative
  */
@@ -22,4 +36,30 @@ public:
 	UPROPERTY(EditAnywhere, config, Category = "Quest Settings")
 	bool bResetTasksWhenCompleted;
 
+	//How many milliseconds a frame can be spent spawning actors quests asked for with SpawnQuestActorDeferred. At least one is always spawned a frame.
+	UPROPERTY(EditAnywhere, config, Category = "Quest Actors", meta = (ClampMin = 0))
+	float QuestActorSpawnBudgetMs;
+
+	//How many milliseconds a frame BeginQuestAsync can spend making and beginning quests once they've loaded. At least one step is always taken
+	//each frame, so a single quest that takes longer than this still gets begun. Dialogues use AsyncBeginBudgetMs in the dialogue settings.
+	UPROPERTY(EditAnywhere, config, Category = "Async Loading", meta = (ClampMin = 0))
+	float AsyncBeginBudgetMs;
+
+	//Quest actor classes that should be pooled instead of destroyed when their quest ends, and the most of each class to keep pooled.
+	//Pooled actors are hidden and have collision and ticking turned off, so only pool actors that don't need to be reset beyond that.
+	UPROPERTY(EditAnywhere, config, Category = "Quest Actors")
+	TMap<TSoftClassPtr<class AActor>, int32> PooledQuestActorClasses;
+
+	//Once a narrative component has sent more quest updates than this, the server folds the older half into a snapshot of where each quest is at, 
+	//so clients that join late load the snapshot in instead of replaying every update. Updates the owning client hasn't acknowledged yet are 
+	//never folded, so the list can briefly grow past this. Set to 0 to never snapshot and keep the full update history.
+	UPROPERTY(EditAnywhere, config, Category = "Replication", meta = (ClampMin = 0))
+	int32 MaxReplicatedUpdateHistory;
+
+	//Who a players quest updates are replicated to. Only the owner needs them, so anything else costs bandwidth for every player that can see them. 
+	//Narrative components on player controllers only ever replicate to their owner, so this only matters if yours live on a pawn or player state.
+	//Party components always replicate their quest updates to everyone, since they're shared by the whole party.
+	UPROPERTY(EditAnywhere, config, Category = "Replication")
+	ENarrativeQuestReplicationPolicy QuestReplicationPolicy;
+
 };
@@ -24,6 +24,7 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnQuestFailed, const UQuest*, Ques
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnQuestStarted, const UQuest*, Quest);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnQuestForgotten, const UQuest*, Quest);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnQuestRestarted, const UQuest*, Quest);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnQuestActorsReady, UQuest*, Quest);
 
 // Represents the state of a particular quest
 UENUM(BlueprintType)
@@ -49,6 +50,7 @@ protected:
 	friend class UQuestState;
 	friend class UQuestBranch;
 	friend class UNarrativeComponent;
+	friend class UNarrativeQuestActorSpawner;
 
 	UQuest();
 
@@ -171,6 +173,12 @@ protected:
 	UPROPERTY()
 	TArray<class AActor*> QuestActors;
 
+	//How many actors we've asked the quest actor spawner for that haven't spawned yet
+	int32 NumPendingQuestActors;
+
+	//The quest actor spawner has got round to one of our deferred spawns. Actor is null if its class couldn't be loaded
+	virtual void OnDeferredQuestActorSpawned(class AActor* Actor);
+
 	/**All the states we've reached so far. Useful for a quest journal, where we need to show the player what they have done so far*/
 	UPROPERTY(BlueprintReadOnly, Category = "Quests")
 	TArray<UQuestState*> ReachedStates;
@@ -220,6 +228,10 @@ protected:
 	UPROPERTY(BlueprintAssignable, Category = "Quests")
 		FOnQuestRestarted QuestRestarted;
 
+	/**Called when every actor asked for with SpawnQuestActorDeferred has spawned.*/
+	UPROPERTY(BlueprintAssignable, Category = "Quests")
+		FOnQuestActorsReady QuestActorsReady;
+
 public:
 
 	/*
@@ -230,6 +242,18 @@ public:
 	AActor* SpawnQuestActor(TSubclassOf<class AActor> ActorClass, const FTransform& ActorTransform);
 	virtual AActor* SpawnQuestActor_Implementation(TSubclassOf<class AActor> ActorClass, const FTransform& ActorTransform);
 
+	/*
+	* Same as SpawnQuestActor, but the actor is spawned over the next few frames by the quest actor spawner, loading its class in the background 
+	* first if it needs to. Use this when a state spawns lots of actors at once so they don't all spawn in the same frame. QuestActorsReady is 
+	* called once every deferred actor has spawned. Actors are spawned with SpawnQuestActor, unless a pooled one is reused instead. 
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Quests")
+	virtual void SpawnQuestActorDeferred(TSoftClassPtr<class AActor> ActorClass, const FTransform& ActorTransform);
+
+	/**Return true if none of the actors asked for with SpawnQuestActorDeferred are still waiting to spawn*/
+	UFUNCTION(BlueprintPure, Category = "Quests")
+	bool AreQuestActorsReady() const { return NumPendingQuestActors == 0; }
+
 	void AddState(class UQuestState* State);
 	void AddBranch(class UQuestBranch* Branch);
 
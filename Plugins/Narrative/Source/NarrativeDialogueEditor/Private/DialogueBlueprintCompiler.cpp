@@ -148,6 +148,21 @@ void FDialogueBlueprintCompilerContext::FinishCompilingClass(UClass* Class)
 			UDialogue* NewDialogueTemplate = Cast<UDialogue>(StaticDuplicateObject(DialogueBP->DialogueTemplate, BPGClass, NAME_None, RF_AllFlags & ~RF_DefaultSubObject));
 			BPGClass->SetDialogueTemplate(NewDialogueTemplate);
 
+			//Split each nodes events up by runtime, and store each lines audio length so the dialogue doesn't need to work these out whenever a node plays 
+			if (NewDialogueTemplate)
+			{
+				NewDialogueTemplate->BakeNodeTableChecksum();
+
+				for (auto& Node : NewDialogueTemplate->GetNodes())
+				{
+					if (Node)
+					{
+						Node->PartitionEvents();
+						Node->BakeLineDurations();
+					}
+				}
+			}
+
 			DialogueBP->DialogueTemplate->SetFlags(PreviousFlags);
 
 
@@ -175,7 +190,7 @@ void FDialogueBlueprintCompilerContext::FinishCompilingClass(UClass* Class)
 						{
 							if (DialogueSettings->bWarnMissingSoundCues)
 							{
-								if (!Node->Line.Text.IsEmpty() && !Node->Line.DialogueSound)
+								if (!Node->Line.Text.IsEmpty() && Node->Line.DialogueSound.IsNull())
 								{
 									FText MissingSoundWarning = FText::Format(LOCTEXT("MissingSoundWarning", "Found node {0} that is missing audio cues. Turn off bWarnMissingSoundCues in your Project Settings to disable this warning."), FText::FromString(Node->GetID().ToString()));
 									MessageLog.Warning(*MissingSoundWarning.ToString());
@@ -148,6 +148,18 @@ void FQuestBlueprintCompilerContext::FinishCompilingClass(UClass* Class)
 			UQuest* NewQuestTemplate = Cast<UQuest>(StaticDuplicateObject(QuestBP->QuestTemplate, BPGClass, NAME_None, RF_AllFlags & ~RF_DefaultSubObject));
 			BPGClass->SetQuestTemplate(NewQuestTemplate);
 
+			//Split each nodes events up by runtime so the quest doesn't need to filter them whenever a state/branch activates 
+			if (NewQuestTemplate)
+			{
+				for (auto& Node : NewQuestTemplate->GetNodes())
+				{
+					if (Node)
+					{
+						Node->PartitionEvents();
+					}
+				}
+			}
+
 			QuestBP->QuestTemplate->SetFlags(PreviousFlags);
 		}
 